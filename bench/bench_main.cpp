@@ -0,0 +1,307 @@
+// bench_auto_repair: times the hot paths of the core on synthetic data and
+// writes the results as JSON, so runs from two commits can be compared with
+// tools/bench_compare.py.
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "bench/synthetic_data.hpp"
+#include "domain/maintenance_detector.hpp"
+#include "domain/search_index.hpp"
+#include "inventory/store_house.hpp"
+#include "metrics/metrics_file_writer.hpp"
+#include "persistence/data_store_persistence.hpp"
+#include "report/allocation_counter.hpp"
+#include "report/memory_footprint.hpp"
+#include "report/report_service.hpp"
+#include "trace/tracer.hpp"
+
+#ifndef AUTO_REPAIR_GIT_COMMIT
+#define AUTO_REPAIR_GIT_COMMIT "unknown"
+#endif
+
+namespace {
+struct BenchResult {
+  std::string name;
+  std::size_t items{0}; // operations per repeat
+  std::vector<std::int64_t> ns; // one sample per repeat
+
+  std::int64_t minNs() const { return *std::min_element(ns.begin(), ns.end()); }
+  std::int64_t medianNs() const {
+    auto sorted = ns;
+    std::sort(sorted.begin(), sorted.end());
+    return sorted[sorted.size() / 2];
+  }
+  double nsPerItem() const { return items ? static_cast<double>(medianNs()) / items : 0; }
+};
+
+// Defeats dead-code elimination of benchmarked results
+volatile std::uint64_t g_sink = 0;
+
+std::int64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Runs `setup` untimed and `body` timed, `repeats` times.
+BenchResult measure(const std::string& name, std::size_t items, int repeats,
+                    const std::function<void()>& setup, const std::function<void()>& body) {
+  BenchResult r{name, items, {}};
+  for (int i = 0; i < repeats; ++i) {
+    if (setup) setup();
+    const auto start = nowNs();
+    body();
+    r.ns.push_back(nowNs() - start);
+  }
+  std::cout << name << ": " << r.items << " items, median " << r.medianNs() / 1e6 << " ms, "
+            << r.nsPerItem() << " ns/item" << std::endl;
+  return r;
+}
+
+std::size_t parseCount(const char* text) {
+  // Accepts 1000, 10k, 1m
+  char* end = nullptr;
+  auto n = std::strtoull(text, &end, 10);
+  if (*end == 'k' || *end == 'K') n *= 1000;
+  else if (*end == 'm' || *end == 'M') n *= 1000000;
+  return static_cast<std::size_t>(n);
+}
+
+// "1,2,4,8"
+std::vector<unsigned> parseThreadList(const char* text) {
+  std::vector<unsigned> threads;
+  for (const char* p = text; *p;) {
+    char* end = nullptr;
+    const auto n = std::strtoul(p, &end, 10);
+    if (end == p) break;
+    if (n > 0) threads.push_back(static_cast<unsigned>(n));
+    p = *end == ',' ? end + 1 : end;
+  }
+  return threads;
+}
+
+QJsonObject toJson(const BenchResult& r) {
+  QJsonArray samples;
+  for (auto v : r.ns) samples.push_back(static_cast<qint64>(v));
+  return QJsonObject{{"name", QString::fromStdString(r.name)}, {"items", static_cast<qint64>(r.items)},
+                     {"min_ns", static_cast<qint64>(r.minNs())}, {"median_ns", static_cast<qint64>(r.medianNs())},
+                     {"ns_per_item", r.nsPerItem()}, {"samples_ns", samples}};
+}
+}
+
+int main(int argc, char* argv[]) {
+  // Rollups bucket days in local time; pin it so every machine sees the same data
+#ifdef _WIN32
+  _putenv_s("TZ", "UTC");
+  _tzset();
+#else
+  setenv("TZ", "UTC", 1);
+  tzset();
+#endif
+  Tracer::installFromEnvironment();
+  MetricsFileWriter::installFromEnvironment();
+  Tracer::setThreadName("bench");
+  SyntheticScale scale;
+  std::uint64_t seed = 42;
+  int repeats = 5;
+  std::size_t detectSample = 2000;
+  std::string out = "bench_results.json";
+  std::string label;
+  std::vector<unsigned> threadCounts;
+  auto workdir = std::filesystem::temp_directory_path() / "auto_repair_bench";
+  for (int i = 1; i < argc; ++i) {
+    auto arg = [&](const char* name) { return std::strcmp(argv[i], name) == 0 && i + 1 < argc; };
+    if (arg("--size")) scale = SyntheticScale::uniform(parseCount(argv[++i]));
+    else if (arg("--customers")) scale.customers = parseCount(argv[++i]);
+    else if (arg("--vehicles")) scale.vehicles = parseCount(argv[++i]);
+    else if (arg("--orders")) scale.orders = parseCount(argv[++i]);
+    else if (arg("--parts")) scale.parts = parseCount(argv[++i]);
+    else if (arg("--seed")) seed = std::strtoull(argv[++i], nullptr, 10);
+    else if (arg("--repeat")) repeats = std::max(1, std::atoi(argv[++i]));
+    else if (arg("--detect-sample")) detectSample = parseCount(argv[++i]);
+    else if (arg("--out")) out = argv[++i];
+    else if (arg("--label")) label = argv[++i];
+    else if (arg("--workdir")) workdir = argv[++i];
+    else if (arg("--threads")) threadCounts = parseThreadList(argv[++i]);
+    else {
+      std::cerr << "usage: bench_auto_repair [--size 1k|100k|1m] [--customers N] [--vehicles N] [--orders N]"
+                   " [--parts N] [--seed N] [--repeat N] [--detect-sample N] [--threads 1,2,4,8]"
+                   " [--out results.json] [--label text] [--workdir dir]" << std::endl;
+      return 2;
+    }
+  }
+
+  const auto genStart = nowNs();
+  const auto heapBefore = AllocationCounter::liveBytes();
+  DataStore store;
+  SyntheticData::generate(store, scale, seed);
+  const auto heapGenerated = AllocationCounter::liveBytes() - heapBefore;
+  std::cout << "generated " << store.customers.size() << " customers, " << store.vehicles.size() << " vehicles, "
+            << store.workOrders.size() << " orders, " << store.parts.size() << " parts in "
+            << (nowNs() - genStart) / 1e6 << " ms" << std::endl;
+
+  std::filesystem::create_directories(workdir);
+  const auto dataPath = (workdir / "data_store.json").string();
+  std::vector<BenchResult> results;
+
+  // Footprint of the generated store, so layout changes show up next to timings
+  StoreHouse catalogHouse(store.parts);
+  const auto memory = MemoryFootprint::measure(store, &catalogHouse);
+  memory.writeTable(std::cout);
+  QJsonObject memoryJson{{"total_bytes", static_cast<qint64>(memory.total())}};
+  if (AllocationCounter::enabled()) memoryJson.insert("heap_bytes_measured", static_cast<qint64>(heapGenerated));
+  QJsonArray memoryRows;
+  for (const auto& r : memory.rows) {
+    memoryRows.push_back(QJsonObject{{"type", QString::fromStdString(r.type)}, {"count", static_cast<qint64>(r.count)},
+                                     {"inline_bytes", static_cast<qint64>(r.inlineBytes)},
+                                     {"heap_bytes", static_cast<qint64>(r.heapBytes)},
+                                     {"string_bytes", static_cast<qint64>(r.stringBytes)},
+                                     {"total_bytes", static_cast<qint64>(r.total())}});
+  }
+  memoryJson.insert("types", memoryRows);
+
+  // Persistence
+  results.push_back(measure("persistence.save", store.workOrders.size(), repeats, {},
+                            [&] { DataStorePersistence::save(store, dataPath); }));
+  results.push_back(measure("persistence.load.full", store.workOrders.size(), repeats, {}, [&] {
+    auto loaded = DataStorePersistence::load(dataPath, DataStorePersistence::LoadMode::Full);
+    g_sink += loaded.workOrders.size();
+  }));
+  results.push_back(measure("persistence.load.headers", store.workOrders.size(), repeats, {}, [&] {
+    auto loaded = DataStorePersistence::load(dataPath, DataStorePersistence::LoadMode::HeadersOnly);
+    g_sink += loaded.workOrders.size();
+  }));
+
+  // Detection, over a sample of vehicles: each call scans the stock list
+  const std::size_t detectCount = std::min(detectSample, store.vehicles.size());
+  results.push_back(measure("detector.detect", detectCount, repeats, {}, [&] {
+    for (std::size_t i = 0; i < detectCount; ++i) {
+      g_sink += MaintenanceDetector::detect(store.vehicles[i], store.parts, &store.serviceHistory).items.size();
+    }
+  }));
+
+  // Consumption, against a storehouse restocked before every repeat
+  StoreHouse storeHouse;
+  std::vector<Part> deepStock = store.parts;
+  for (auto& p : deepStock) p.stock = 1 << 30;
+  results.push_back(measure("storehouse.consumeForOrder", store.workOrders.size(), repeats,
+                            [&] { storeHouse.seed(deepStock); }, [&] {
+    for (const auto& w : store.workOrders) g_sink += storeHouse.consumeForOrder(w);
+    g_sink += storeHouse.takeAlerts().size();
+  }));
+
+  // Reports
+  results.push_back(measure("report.columns.rebuild", store.workOrders.size(), repeats, {}, [&] {
+    store.orderColumns.rebuild(store.workOrders);
+    g_sink += store.orderColumns.size();
+  }));
+  results.push_back(measure("report.summary", store.workOrders.size(), repeats, {}, [&] {
+    g_sink += ReportService::summary(store.orderColumns, store.parts).paidCount;
+  }));
+  results.push_back(measure("report.turnover", store.workOrders.size(), repeats, {}, [&] {
+    g_sink += ReportService::turnover(store.orderColumns).count;
+  }));
+  // Scaling of the parallel reduction; defaults to 1, 2, 4 ... up to the core count
+  if (threadCounts.empty()) {
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned t = 1; t < cores; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(cores);
+  }
+  for (auto t : threadCounts) {
+    const auto suffix = ".threads" + std::to_string(t);
+    results.push_back(measure("report.summary" + suffix, store.workOrders.size(), repeats, {}, [&] {
+      g_sink += ReportEngine::summarize(store.orderColumns, store.parts, t).paidCount;
+    }));
+    results.push_back(measure("report.summary.ids" + suffix, store.workOrders.size(), repeats, {}, [&] {
+      g_sink += ReportEngine::summarize(store.orderColumns, store.parts, t, true).statusBuckets.size();
+    }));
+    results.push_back(measure("report.turnover" + suffix, store.workOrders.size(), repeats, {}, [&] {
+      g_sink += ReportEngine::turnover(store.orderColumns, t).count;
+    }));
+  }
+  // The year the synthetic orders cover, plus the day the last ones settle
+  const int firstDay = TurnoverRollup::dayOf(SyntheticData::kBaseMs);
+  results.push_back(measure("report.turnover.rollup", 1, repeats, {}, [&] {
+    g_sink += ReportService::turnover(store.turnoverRollup, firstDay, firstDay + 366).count;
+  }));
+
+  // Search, over every vehicle, customer and part
+  SearchIndex search;
+  const std::size_t searchEntries = store.vehicles.size() + store.customers.size() + store.parts.size();
+  results.push_back(measure("search.build", searchEntries, repeats, [&] { search.clear(); }, [&] {
+    for (const auto& v : store.vehicles) search.addVehicle(v);
+    for (const auto& c : store.customers) search.addCustomer(c);
+    for (const auto& p : store.parts) search.addPart(p);
+    g_sink += search.size();
+  }));
+  // Common queries match most plates or names; rare ones a single entry
+  constexpr std::size_t kQueries = 1000;
+  const std::string rarePlate = store.vehicles.empty() ? "zzz" : store.vehicles.back().plate;
+  const std::pair<const char*, std::string> queries[] = {
+    {"search.query.prefix.common", "p"},
+    {"search.query.prefix.rare", "en"},
+    {"search.query.trigram.common", "customer"},
+    {"search.query.trigram.rare", rarePlate},
+  };
+  for (const auto& [name, query] : queries) {
+    results.push_back(measure(name, kQueries, repeats, {}, [&, query = query] {
+      for (std::size_t i = 0; i < kQueries; ++i) g_sink += search.search(query).size();
+    }));
+  }
+
+  // WorkOrder copy and move
+  std::vector<WorkOrder> copies;
+  results.push_back(measure("workorder.copy", store.workOrders.size(), repeats, [&] { copies.clear(); }, [&] {
+    copies = store.workOrders;
+    g_sink += copies.size();
+  }));
+  std::vector<WorkOrder> moved;
+  results.push_back(measure("workorder.move", copies.size(), repeats, [&] {
+    copies = store.workOrders;
+    moved.clear();
+    moved.reserve(copies.size());
+  }, [&] {
+    for (auto& w : copies) moved.push_back(std::move(w));
+    g_sink += moved.size();
+  }));
+
+  QJsonArray list;
+  for (const auto& r : results) list.push_back(toJson(r));
+  QJsonObject root{
+      {"commit", label.empty() ? QString(AUTO_REPAIR_GIT_COMMIT) : QString::fromStdString(label)},
+      {"timestamp", static_cast<qint64>(std::chrono::duration_cast<std::chrono::seconds>(
+                        std::chrono::system_clock::now().time_since_epoch()).count())},
+      {"threads", static_cast<int>(std::thread::hardware_concurrency())},
+      {"seed", static_cast<qint64>(seed)},
+      {"repeats", repeats},
+      {"scale", QJsonObject{{"customers", static_cast<qint64>(scale.customers)},
+                            {"vehicles", static_cast<qint64>(scale.vehicles)},
+                            {"orders", static_cast<qint64>(scale.orders)},
+                            {"parts", static_cast<qint64>(scale.parts)}}},
+      {"results", list},
+      {"memory", memoryJson}};
+  QSaveFile file(QString::fromStdString(out));
+  if (!file.open(QIODevice::WriteOnly)) {
+    std::cerr << "cannot write " << out << std::endl;
+    return 1;
+  }
+  file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+  if (!file.commit()) {
+    std::cerr << "cannot write " << out << std::endl;
+    return 1;
+  }
+  std::cout << "results written to " << out << " (sink " << g_sink << ")" << std::endl;
+  return 0;
+}
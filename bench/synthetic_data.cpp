@@ -0,0 +1,153 @@
+#include "bench/synthetic_data.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+namespace {
+// SplitMix64: tiny, fast and identical everywhere, unlike the distributions
+// in <random>, whose output is implementation-defined.
+class Rng {
+  std::uint64_t state_;
+public:
+  explicit Rng(std::uint64_t seed) : state_(seed) {}
+  std::uint64_t next() {
+    std::uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+  std::size_t below(std::size_t n) { return n ? static_cast<std::size_t>(next() % n) : 0; }
+};
+
+std::string code(const char* prefix, std::size_t n, int width) {
+  char buf[48];
+  std::snprintf(buf, sizeof(buf), "%s%0*zu", prefix, width, n);
+  return buf;
+}
+
+const char* const kBrands[] = {"Toyota", "Honda", "Ford", "BMW", "Tesla", "Hyundai"};
+const char* const kModels[] = {"Corolla", "Civic", "Focus", "320i", "Model 3", "Elantra"};
+
+struct Service {
+  const char* id;
+  const char* name;
+  double laborHours;
+  double basePrice;
+};
+const Service kServices[] = {
+  {"S-OIL", "Oil Change", 0.5, 30},
+  {"S-AIR", "Air Filter", 0.3, 20},
+  {"S-BRAKE", "Brake Pads", 1.5, 60},
+  {"S-INSPECT", "Inspection", 1.0, 40},
+  {"S-TIRE", "Tire Rotation", 0.8, 25},
+};
+}
+
+void SyntheticData::generate(DataStore& store, const SyntheticScale& scale, std::uint64_t seed) {
+  Rng rng(seed);
+  constexpr std::int64_t kMinuteMs = 60 * 1000;
+
+  store.customers.reserve(scale.customers);
+  for (std::size_t i = 0; i < scale.customers; ++i) {
+    Customer c;
+    c.id = code("C", i + 1, 7);
+    c.name = "Customer " + std::to_string(i + 1);
+    c.phone = code("13", rng.below(1000000000), 9);
+    c.level = rng.below(5) == 0 ? 1 : 0;
+    store.customers.push_back(std::move(c));
+  }
+
+  store.vehicles.reserve(scale.vehicles);
+  for (std::size_t i = 0; i < scale.vehicles; ++i) {
+    Vehicle v;
+    v.vin = code("VIN", rng.next() % 100000000000000ULL, 14);
+    v.plate = code("P", i + 1, 7);
+    const auto model = rng.below(std::size(kBrands));
+    v.brand = kBrands[model];
+    v.model = kModels[model];
+    v.year = 2005 + static_cast<int>(rng.below(20));
+    v.ownerId = scale.customers ? store.customers[i % scale.customers].id : std::string();
+    v.mileage = static_cast<int>(rng.below(200000));
+    store.vehicles.push_back(std::move(v));
+  }
+
+  // The first four ids are the ones MaintenanceDetector asks for
+  const Part fixed[] = {{"P001", "Engine Oil", 50, 0, 5, 0}, {"P002", "Oil Filter", 30, 0, 4, 0},
+                        {"P003", "Air Filter", 45, 0, 3, 0}, {"P004", "Brake Pads", 120, 0, 2, 0}};
+  store.parts.reserve(std::max<std::size_t>(scale.parts, 4));
+  for (std::size_t i = 0; i < std::max<std::size_t>(scale.parts, 4); ++i) {
+    Part p = i < 4 ? fixed[i] : Part{code("P", i + 1, 7), "Part " + std::to_string(i + 1), 5.0 + static_cast<double>(rng.below(500)), 0, 5, 0};
+    p.capacity = 1000 + static_cast<int>(rng.below(9000));
+    p.stock = p.capacity / 2 + static_cast<int>(rng.below(static_cast<std::size_t>(p.capacity / 2)));
+    store.parts.push_back(std::move(p));
+  }
+
+  const std::size_t technicians = std::max<std::size_t>(4, scale.orders / 500);
+  for (std::size_t i = 0; i < technicians; ++i) {
+    Technician t;
+    t.id = code("T", i + 1, 5);
+    t.name = "Technician " + std::to_string(i + 1);
+    t.hourlyRate = 80 + static_cast<double>(rng.below(80));
+    store.technicians.push_back(std::move(t));
+  }
+
+  store.workOrders.reserve(scale.orders);
+  if (!store.itemArena.active()) store.itemArena = ItemArena::pooled();
+  for (std::size_t i = 0; i < scale.orders && !store.vehicles.empty(); ++i) {
+    WorkOrder w(store.itemArena.resource());
+    w.id = code("WO", i + 1, 7);
+    w.vehicle = store.vehicles[i % store.vehicles.size()];
+    w.customer = scale.customers ? store.customers[(i % store.vehicles.size()) % scale.customers] : Customer{};
+    w.advisor.id = "E200";
+    w.advisor.name = "Eve";
+    auto& tech = store.technicians[rng.below(technicians)];
+    w.tech.id = tech.id;
+    w.tech.name = tech.name;
+    w.tech.hourlyRate = tech.hourlyRate;
+
+    const std::size_t items = 1 + rng.below(3);
+    for (std::size_t k = 0; k < items; ++k) {
+      const auto& s = kServices[rng.below(std::size(kServices))];
+      WOItem item(w.items.get_allocator());
+      item.item = ServiceItem{s.id, s.name, s.laborHours, s.basePrice};
+      item.laborHoursOverride = rng.below(4) == 0 ? s.laborHours * 1.5 : -1;
+      item.autoDetected = k == 0;
+      const std::size_t parts = rng.below(3);
+      for (std::size_t p = 0; p < parts; ++p) {
+        item.parts.emplace_back(store.parts[rng.below(store.parts.size())], 1 + static_cast<int>(rng.below(3)));
+      }
+      w.items.push_back(std::move(item));
+    }
+
+    // Spread over a year; six in ten orders are paid, the rest at earlier stages
+    const std::int64_t created = kBaseMs + static_cast<std::int64_t>(rng.below(365 * 24 * 60)) * kMinuteMs;
+    auto stamp = [](std::int64_t ms) { return StageStamp{ms * 1000, ms}; };
+    w.lifecycle.created = stamp(created);
+    const auto roll = rng.below(10);
+    const WOStatus status = roll < 6 ? WOStatus::Paid : roll == 6 ? WOStatus::Completed : roll == 7 ? WOStatus::InProgress
+                          : roll == 8 ? WOStatus::Assigned : WOStatus::Draft;
+    std::int64_t at = created;
+    auto advance = [&](StageStamp& s) { at += static_cast<std::int64_t>(5 + rng.below(240)) * kMinuteMs; s = stamp(at); };
+    if (status != WOStatus::Draft) advance(w.lifecycle.assigned);
+    if (status == WOStatus::InProgress || status == WOStatus::Completed || status == WOStatus::Paid) advance(w.lifecycle.started);
+    if (status == WOStatus::Completed || status == WOStatus::Paid) advance(w.lifecycle.completed);
+    if (status == WOStatus::Paid) {
+      advance(w.lifecycle.settled);
+      w.closedAt = at;
+      w.partsConsumed = true;
+    }
+    w.status = status;
+    w.version = static_cast<std::uint64_t>(status);
+    if (status != WOStatus::Draft) tech.assignedWorkOrders.push_back(IdTable::workOrders().intern(w.id));
+
+    store.lifecycleStats.observe(w);
+    if (status == WOStatus::Paid) {
+      store.serviceHistory.record(w);
+      store.turnoverRollup.add(w);
+      store.topN.record(w, true);
+    }
+    store.workOrders.push_back(std::move(w));
+  }
+  store.orderColumns.rebuild(store.workOrders);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "domain/data_store.hpp"
+
+// Deterministic synthetic shop data for benchmarks. The same scale and seed
+// give the same orders on every platform: the generator uses its own
+// SplitMix64 stream and a fixed base date instead of the clock. The turnover
+// rollup buckets days in local time, so it also depends on TZ;
+// bench_auto_repair pins TZ to UTC.
+struct SyntheticScale {
+  std::size_t customers{1000};
+  std::size_t vehicles{1000};
+  std::size_t orders{1000};
+  std::size_t parts{1000};
+
+  // Every count set to n
+  static SyntheticScale uniform(std::size_t n) { return SyntheticScale{n, n, n, n}; }
+};
+
+class SyntheticData {
+public:
+  // Fills an empty store, including the derived report indexes.
+  static void generate(DataStore& store, const SyntheticScale& scale, std::uint64_t seed = 42);
+  // 2025-01-01T00:00:00Z; generated timestamps count from here.
+  static constexpr std::int64_t kBaseMs = 1735689600000LL;
+};
@@ -0,0 +1,71 @@
+// Headless replay of a command file through the core, for load runs and
+// scripted data entry. No widget code is linked in.
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "batch/batch_runner.hpp"
+#include "domain/change_bus.hpp"
+#include "inventory/store_house.hpp"
+#include "metrics/metrics_file_writer.hpp"
+#include "persistence/change_log.hpp"
+#include "persistence/data_store_persistence.hpp"
+#include "persistence/store_bootstrap.hpp"
+#include "persistence/work_order_archive.hpp"
+#include "trace/tracer.hpp"
+
+int main(int argc, char* argv[]) {
+  Tracer::installFromEnvironment();
+  MetricsFileWriter::installFromEnvironment();
+  Tracer::setThreadName("batch");
+  std::string commandsPath;
+  std::string dataPath = "data/data_store.json";
+  bool dryRun = false;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--data") == 0 && i + 1 < argc) dataPath = argv[++i];
+    else if (std::strcmp(argv[i], "--dry-run") == 0) dryRun = true;
+    else commandsPath = argv[i];
+  }
+  if (commandsPath.empty()) {
+    std::cerr << "usage: auto_repair_batch <commands.csv> [--data data_store.json] [--dry-run]" << std::endl;
+    return 2;
+  }
+  std::ifstream in(commandsPath);
+  if (!in) {
+    std::cerr << "cannot read " << commandsPath << std::endl;
+    return 1;
+  }
+
+  // An import into a new data file starts empty, without the GUI's sample data
+  DataStore store = DataStorePersistence::load(dataPath, DataStorePersistence::LoadMode::HeadersOnly);
+  StoreBootstrap::seedParts(store);
+  WorkOrderArchive archive(WorkOrderArchive::directoryFor(dataPath));
+  if (!dryRun) StoreBootstrap::archiveAged(store, archive, dataPath);
+  StoreHouse storeHouse(store.parts);
+  WorkshopService service(store, storeHouse, archive.archivedCount());
+  // A saving run is a primary run: reporting followers replay its changes
+  ChangeBus bus;
+  ChangeLogWriter changeLog(store, ChangeLogWriter::pathFor(dataPath));
+  if (!dryRun) {
+    changeLog.restart();
+    // Written out once the run is over rather than per operation
+    changeLog.setFlushEachRecord(false);
+    bus.addObserver(&changeLog);
+    service.setChangeBus(&bus);
+  }
+  BatchRunner runner(service);
+
+  auto report = runner.run(in);
+  for (const auto& e : report.errors) std::cerr << e << '\n';
+  if (report.failed > report.errors.size()) {
+    std::cerr << "... " << report.failed - report.errors.size() << " more errors" << '\n';
+  }
+  std::cout << report.ops << " ops, " << report.failed << " failed (" << report.conflicts << " version conflicts), "
+            << report.seconds * 1000 << " ms, " << static_cast<long long>(report.opsPerSecond()) << " ops/s" << std::endl;
+
+  if (!dryRun) {
+    changeLog.flush();
+    DataStorePersistence::save(store, dataPath);
+  }
+  return report.failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+#include "batch/batch_runner.hpp"
+
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+void requireFields(const std::vector<std::string>& fields, std::size_t count) {
+  if (fields.size() < count) {
+    throw std::runtime_error(fields[0] + " expects " + std::to_string(count - 1) + " fields");
+  }
+}
+
+int toInt(const std::string& text) {
+  try {
+    return std::stoi(text);
+  } catch (const std::exception&) {
+    throw std::runtime_error("not a number: " + text);
+  }
+}
+
+// Optional version in column `index`
+std::optional<std::uint64_t> version(const std::vector<std::string>& fields, std::size_t index) {
+  if (fields.size() <= index || fields[index].empty()) return std::nullopt;
+  try {
+    return static_cast<std::uint64_t>(std::stoull(fields[index]));
+  } catch (const std::exception&) {
+    throw std::runtime_error("not a version: " + fields[index]);
+  }
+}
+
+double toDouble(const std::string& text) {
+  try {
+    return std::stod(text);
+  } catch (const std::exception&) {
+    throw std::runtime_error("not a number: " + text);
+  }
+}
+}
+
+std::vector<std::string> BatchRunner::splitFields(const std::string& line) {
+  std::vector<std::string> fields;
+  std::size_t begin = 0;
+  while (true) {
+    auto end = line.find(',', begin);
+    auto field = line.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+    auto first = field.find_first_not_of(" \t\r");
+    auto last = field.find_last_not_of(" \t\r");
+    fields.push_back(first == std::string::npos ? std::string() : field.substr(first, last - first + 1));
+    if (end == std::string::npos) break;
+    begin = end + 1;
+  }
+  return fields;
+}
+
+BatchReport BatchRunner::run(std::istream& in) {
+  BatchReport report;
+  const auto started = std::chrono::steady_clock::now();
+  std::string line;
+  std::size_t lineNo = 0;
+  while (std::getline(in, line)) {
+    ++lineNo;
+    auto fields = splitFields(line);
+    if (fields[0].empty() || fields[0][0] == '#') continue;
+    ++report.ops;
+    try {
+      apply(fields);
+    } catch (const VersionConflict& e) {
+      ++report.failed;
+      ++report.conflicts;
+      if (report.errors.size() < kMaxErrors) {
+        report.errors.push_back("line " + std::to_string(lineNo) + ": " + e.what());
+      }
+    } catch (const std::exception& e) {
+      ++report.failed;
+      if (report.errors.size() < kMaxErrors) {
+        report.errors.push_back("line " + std::to_string(lineNo) + ": " + e.what());
+      }
+    }
+  }
+  report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+  return report;
+}
+
+void BatchRunner::apply(const std::vector<std::string>& fields) {
+  const auto& op = fields[0];
+  if (op == "customer") {
+    requireFields(fields, 3);
+    Customer c;
+    c.id = fields[1];
+    c.name = fields[2];
+    if (fields.size() > 3) c.phone = fields[3];
+    service_.addCustomer(c);
+  } else if (op == "vehicle") {
+    requireFields(fields, 4);
+    Vehicle v;
+    v.vin = fields[1];
+    v.plate = fields[2];
+    v.ownerId = fields[3];
+    if (fields.size() > 4) v.mileage = toInt(fields[4]);
+    service_.addVehicle(v);
+  } else if (op == "technician") {
+    requireFields(fields, 4);
+    Technician t;
+    t.id = fields[1];
+    t.name = fields[2];
+    t.hourlyRate = toDouble(fields[3]);
+    service_.addTechnician(t);
+  } else if (op == "create") {
+    requireFields(fields, 3);
+    const int mileage = fields.size() > 3 && !fields[3].empty() ? toInt(fields[3]) : 0;
+    service_.createOrder(fields[1], fields[2], mileage);
+  } else if (op == "assign") {
+    requireFields(fields, 3);
+    service_.assign(orderRow(fields[1]), fields[2], version(fields, 3));
+  } else if (op == "start") {
+    requireFields(fields, 2);
+    service_.start(orderRow(fields[1]), version(fields, 2));
+  } else if (op == "complete") {
+    requireFields(fields, 2);
+    service_.complete(orderRow(fields[1]), version(fields, 2));
+  } else if (op == "settle") {
+    requireFields(fields, 2);
+    service_.settle(orderRow(fields[1]), version(fields, 2));
+  } else if (op == "receive") {
+    requireFields(fields, 3);
+    if (!service_.receiveStock(fields[1], toInt(fields[2]), version(fields, 3))) {
+      throw std::runtime_error("unknown part " + fields[1]);
+    }
+  } else if (op == "stock") {
+    requireFields(fields, 3);
+    if (!service_.setStock(fields[1], toInt(fields[2]), version(fields, 3))) {
+      throw std::runtime_error("unknown part " + fields[1]);
+    }
+  } else {
+    throw std::runtime_error("unknown operation " + op);
+  }
+}
+
+std::size_t BatchRunner::orderRow(const std::string& ref) const {
+  auto row = service_.findOrder(ref);
+  if (!row) throw std::runtime_error("no work order for " + ref);
+  return *row;
+}
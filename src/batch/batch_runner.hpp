@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+#include "service/workshop_service.hpp"
+
+struct BatchReport {
+  std::size_t ops{0};
+  std::size_t failed{0};
+  std::size_t conflicts{0}; // failures due to a stale version
+  double seconds{0};
+  std::vector<std::string> errors; // the first few, prefixed with the line number
+
+  double opsPerSecond() const { return seconds > 0 ? ops / seconds : 0; }
+};
+
+// Replays a CSV of operations through WorkshopService, one per line:
+//   customer,<id>,<name>,<phone>
+//   vehicle,<vin>,<plate>,<ownerId>,<mileage>
+//   technician,<id>,<name>,<hourlyRate>
+//   create,<vin>,<techId>[,<mileage>]
+//   assign,<order id or vin>,<techId>[,<version>]
+//   start|complete|settle,<order id or vin>[,<version>]
+//   receive,<partId>,<qty>[,<version>]
+//   stock,<partId>,<count>[,<version>]
+// A trailing version makes the update conditional on the order or part
+// still being at that version. Blank lines and lines starting with '#' are
+// skipped. A failing operation is counted and the run continues with the
+// next line.
+class BatchRunner {
+public:
+  static constexpr std::size_t kMaxErrors = 20;
+
+  explicit BatchRunner(WorkshopService& service) : service_(service) {}
+
+  BatchReport run(std::istream& in);
+  // Applies one parsed line; throws std::runtime_error when it is rejected.
+  void apply(const std::vector<std::string>& fields);
+
+  static std::vector<std::string> splitFields(const std::string& line);
+
+private:
+  WorkshopService& service_;
+
+  std::size_t orderRow(const std::string& ref) const;
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+enum class Entity { Customer, Vehicle, Technician, WorkOrder, Part };
+enum class Change { Added, Updated };
+
+// One mutation of a DataStore vector: `row` is the index of the element
+// that was appended or changed (DataStore::parts for Entity::Part).
+struct ChangeEvent {
+  Entity entity;
+  Change change;
+  std::size_t row{0};
+};
+
+class ChangeObserver {
+public:
+  virtual ~ChangeObserver() = default;
+  virtual void onChange(const ChangeEvent& event) = 0;
+};
+
+// Synchronous fan-out of change events. Observers decide themselves whether
+// to act at once or batch events for later.
+class ChangeBus {
+  std::vector<ChangeObserver*> obs_;
+public:
+  void addObserver(ChangeObserver* o) { obs_.push_back(o); }
+  void removeObserver(ChangeObserver* o) { obs_.erase(std::remove(obs_.begin(), obs_.end(), o), obs_.end()); }
+  void publish(const ChangeEvent& event) const {
+    for (auto* o : obs_) o->onChange(event);
+  }
+  void publish(Entity entity, Change change, std::size_t row) const { publish(ChangeEvent{entity, change, row}); }
+};
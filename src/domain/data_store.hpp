@@ -6,12 +6,28 @@
 #include "employee.hpp"
 #include "work_order.hpp"
 #include "part.hpp"
+#include "item_arena.hpp"
+#include "service_history.hpp"
+#include "report/lifecycle_stats.hpp"
+#include "report/turnover_rollup.hpp"
+#include "report/top_n.hpp"
+#include "report/order_columns.hpp"
 
 struct DataStore {
+  ItemArena itemArena; // declared first so it outlives the work orders
   std::vector<Customer> customers;
   std::vector<Vehicle> vehicles;
   std::vector<Technician> technicians;
+  std::vector<ServiceAdvisor> advisors;
+  std::vector<Manager> managers;
   std::vector<WorkOrder> workOrders;
   std::vector<Part> parts;
+  ServiceHistory serviceHistory;
+  LifecycleStats lifecycleStats;
+  TurnoverRollup turnoverRollup;
+  TopNTracker topN;
+  OrderColumns orderColumns; // columnar mirror of workOrders for report scans; not persisted
+  int archiveAfterDays{90}; // closed orders older than this move to the cold archive
+  std::uint64_t logSequence{0}; // last change-log record reflected in this store
 };
 
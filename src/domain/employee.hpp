@@ -1,7 +1,7 @@
-
 #pragma once
 #include <vector>
 #include <string>
+#include "id_table.hpp"
 #include "person.hpp"
 
 struct Employee : public Person {
@@ -9,21 +9,26 @@ struct Employee : public Person {
   virtual ~Employee() = default;
 };
 
-struct Technician : public Employee {
+// The static pay formulas let batch payroll compute a whole group of one
+// type without a virtual call per employee.
+struct Technician final : public Employee {
   double hourlyRate{120.0};
-  int hoursWorked{0};
-  std::vector<std::string> assignedWorkOrders;
-  double calculatePay() const override { return hourlyRate * hoursWorked; }
+  double hoursWorked{0}; // labor hours of the last payroll period, derived from settled orders
+  std::vector<IdHandle> assignedWorkOrders; // IdTable::workOrders() handles
+  static double pay(double hourlyRate, double hours) { return hourlyRate * hours; }
+  double calculatePay() const override { return pay(hourlyRate, hoursWorked); }
 };
 
-struct ServiceAdvisor : public Employee {
+struct ServiceAdvisor final : public Employee {
   double baseSalary{6000.0};
   double commission{0.0};
-  double calculatePay() const override { return baseSalary + commission; }
+  static double pay(double baseSalary, double commission) { return baseSalary + commission; }
+  double calculatePay() const override { return pay(baseSalary, commission); }
 };
 
-struct Manager : public Employee {
+struct Manager final : public Employee {
   double baseSalary{10000.0};
   double bonus{0.0};
-  double calculatePay() const override { return baseSalary + bonus; }
+  static double pay(double baseSalary, double bonus) { return baseSalary + bonus; }
+  double calculatePay() const override { return pay(baseSalary, bonus); }
 };
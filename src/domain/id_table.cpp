@@ -0,0 +1,48 @@
+#include "domain/id_table.hpp"
+
+#include <mutex>
+#include <stdexcept>
+
+IdTable& IdTable::parts() {
+  static IdTable table;
+  return table;
+}
+
+IdTable& IdTable::technicians() {
+  static IdTable table;
+  return table;
+}
+
+IdTable& IdTable::workOrders() {
+  static IdTable table;
+  return table;
+}
+
+IdHandle IdTable::intern(std::string_view id) {
+  if (auto handle = find(id); handle != kNoHandle) return handle;
+  std::unique_lock guard(mutex_);
+  auto it = index_.find(id);
+  if (it != index_.end()) return it->second;
+  if (names_.size() >= kNoHandle) throw std::runtime_error("id table is full");
+  const auto handle = static_cast<IdHandle>(names_.size());
+  names_.emplace_back(id);
+  index_.emplace(names_.back(), handle);
+  return handle;
+}
+
+IdHandle IdTable::find(std::string_view id) const {
+  std::shared_lock guard(mutex_);
+  auto it = index_.find(id);
+  return it == index_.end() ? kNoHandle : it->second;
+}
+
+const std::string& IdTable::name(IdHandle handle) const {
+  std::shared_lock guard(mutex_);
+  if (handle >= names_.size()) throw std::runtime_error("unknown id handle");
+  return names_[handle];
+}
+
+std::size_t IdTable::size() const {
+  std::shared_lock guard(mutex_);
+  return names_.size();
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Dense 32-bit handle of an interned entity id
+using IdHandle = std::uint32_t;
+inline constexpr IdHandle kNoHandle = UINT32_MAX;
+
+// Process-wide intern table of one kind of entity id. Handles are issued
+// 0, 1, 2... in first-seen order and never reused, so maps keyed by them can
+// be plain vectors and comparing two ids is an integer compare. Handles are
+// not persisted; files keep the string ids.
+//
+// Thread-safe: lookups take a shared lock, interning a new id a unique one.
+// Names live as long as the process, which is fine for ids that number in
+// the tens of thousands.
+class IdTable {
+public:
+  static IdTable& parts();
+  static IdTable& technicians();
+  static IdTable& workOrders();
+
+  // The id's handle, issuing a new one on first sight
+  IdHandle intern(std::string_view id);
+  // kNoHandle when the id was never interned
+  IdHandle find(std::string_view id) const;
+  const std::string& name(IdHandle handle) const;
+  std::size_t size() const;
+
+private:
+  mutable std::shared_mutex mutex_;
+  std::deque<std::string> names_; // indexed by handle; a deque keeps the index's keys in place
+  std::unordered_map<std::string_view, IdHandle> index_;
+};
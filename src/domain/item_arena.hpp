@@ -0,0 +1,42 @@
+#pragma once
+#include <memory>
+#include <memory_resource>
+
+// Owns the memory resource a store's work order items and their part lines
+// are allocated from. A pooled arena takes memory from the heap in large
+// chunks, serves the many small vectors a load creates without touching the
+// global allocator, reuses blocks freed by later edits, and hands everything
+// back in one step when the store goes away. It is not thread-safe; a store
+// is used by one thread at a time.
+//
+// Orders that outlive their store must not keep items in its arena. Copies
+// are always made on the default heap, so only moves need care. To keep the
+// store's own orders valid, a store copy starts without an arena, copy
+// assignment keeps the target's arena, and move assignment swaps arenas so
+// the replaced orders are destroyed while theirs is still alive.
+class ItemArena {
+public:
+  ItemArena() = default;
+  ItemArena(const ItemArena&) {}
+  ItemArena(ItemArena&&) noexcept = default;
+  ItemArena& operator=(const ItemArena&) { return *this; }
+  ItemArena& operator=(ItemArena&& other) noexcept {
+    resource_.swap(other.resource_);
+    return *this;
+  }
+
+  static ItemArena pooled() {
+    ItemArena arena;
+    arena.resource_ = std::make_shared<std::pmr::unsynchronized_pool_resource>();
+    return arena;
+  }
+
+  // The default heap when no arena was created
+  std::pmr::memory_resource* resource() const {
+    return resource_ ? resource_.get() : std::pmr::get_default_resource();
+  }
+  bool active() const { return resource_ != nullptr; }
+
+private:
+  std::shared_ptr<std::pmr::memory_resource> resource_;
+};
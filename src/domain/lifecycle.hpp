@@ -0,0 +1,37 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Point in time of a work order transition. steadyUs gives exact durations
+// within one run; wallMs survives restarts and is what gets displayed.
+struct StageStamp {
+  std::int64_t steadyUs{0};
+  std::int64_t wallMs{0};
+
+  bool recorded() const { return wallMs != 0; }
+
+  static StageStamp now() {
+    using namespace std::chrono;
+    return StageStamp{duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count(),
+                      duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count()};
+  }
+};
+
+// Elapsed ms between two stamps. The steady clock is used when both stamps
+// agree with the wall clock (same boot); otherwise the wall clock decides.
+inline std::int64_t elapsedMs(const StageStamp& from, const StageStamp& to) {
+  const std::int64_t wall = to.wallMs - from.wallMs;
+  const std::int64_t steady = (to.steadyUs - from.steadyUs) / 1000;
+  const std::int64_t drift = wall > steady ? wall - steady : steady - wall;
+  if (steady >= 0 && drift < 1000) return steady;
+  return wall > 0 ? wall : 0;
+}
+
+struct Lifecycle {
+  StageStamp created;
+  StageStamp assigned;
+  StageStamp started;
+  StageStamp completed;
+  StageStamp settled;
+};
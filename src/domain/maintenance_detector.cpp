@@ -1,68 +1,141 @@
 #include "domain/maintenance_detector.hpp"
+#include "metrics/metrics_registry.hpp"
+#include "trace/tracer.hpp"
 
 #include <algorithm>
 #include <chrono>
 #include <ctime>
+#include <iterator>
 #include <optional>
 #include <sstream>
 
 namespace {
-std::optional<Part> findPart(const std::vector<Part>& stock, const std::string& id) {
-  auto it = std::find_if(stock.begin(), stock.end(), [&](const Part& p){ return p.id == id; });
+// A part the rules refer to, interned once
+struct KnownPart {
+  const char* id;
+  IdHandle handle;
+  explicit KnownPart(const char* partId) : id(partId), handle(IdTable::parts().intern(partId)) {}
+};
+
+// Storehouse snapshots carry handles, so the scan is mostly integer compares
+std::optional<Part> findPart(const std::vector<Part>& stock, const KnownPart& known) {
+  auto it = std::find_if(stock.begin(), stock.end(), [&](const Part& p) {
+    return p.handle != kNoHandle ? p.handle == known.handle : p.id == known.id;
+  });
   if (it == stock.end()) return std::nullopt;
   return *it;
 }
 
 WOItem makeItem(const std::string& id, const std::string& name, double laborHours, double basePrice,
-                const std::vector<std::pair<Part, int>>& parts, bool detected = true) {
+                std::initializer_list<std::pair<Part, int>> parts, bool detected = true) {
   WOItem item;
   item.item = ServiceItem{id, name, laborHours, basePrice};
-  item.parts = parts;
+  item.parts.assign(parts);
   item.laborHoursOverride = laborHours;
   item.autoDetected = detected;
   return item;
 }
+
+struct ServiceInterval {
+  const char* serviceId;
+  int days;
+  int km;
+};
+
+constexpr ServiceInterval kIntervals[] = {
+  {"S-OIL", 180, 5000},
+  {"S-AIR", 365, 15000},
+  {"S-BRAKE", 365, 20000},
+};
+
+// Returns the last record when the service is still within its interval.
+std::optional<ServiceRecord> recentlyDone(const ServiceHistory* history, const Vehicle& vehicle,
+                                          const std::string& serviceId, std::int64_t nowMs) {
+  if (!history) return std::nullopt;
+  auto rule = std::find_if(std::begin(kIntervals), std::end(kIntervals),
+                           [&](const ServiceInterval& i){ return serviceId == i.serviceId; });
+  if (rule == std::end(kIntervals)) return std::nullopt;
+  auto last = history->last(vehicle.vin, serviceId);
+  if (!last) return std::nullopt;
+  const std::int64_t dayMs = 24LL * 60 * 60 * 1000;
+  if (nowMs - last->completedAt >= rule->days * dayMs) return std::nullopt;
+  if (vehicle.mileage > 0 && last->mileage > 0 && vehicle.mileage - last->mileage >= rule->km) return std::nullopt;
+  return last;
 }
 
-DetectionResult MaintenanceDetector::detect(const Vehicle& vehicle, const std::vector<Part>& stock) {
+std::string skipNote(const std::string& what, const ServiceRecord& rec) {
+  std::ostringstream oss;
+  oss << "Skipped " << what << " (done in " << rec.workOrderId;
+  if (rec.mileage > 0) oss << " at " << rec.mileage << " km";
+  oss << ")";
+  return oss.str();
+}
+}
+
+DetectionResult MaintenanceDetector::detect(const Vehicle& vehicle, const std::vector<Part>& stock,
+                                            const ServiceHistory* history) {
+  TRACE_SCOPE("detector.detect");
+  static auto& detections = MetricsRegistry::global().counter("auto_repair_detections_total", "Maintenance detector runs");
+  detections.inc();
   DetectionResult result;
   auto now = std::chrono::system_clock::now();
+  const std::int64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
   std::time_t tt = std::chrono::system_clock::to_time_t(now);
   std::tm local{};
 #ifdef _WIN32
   localtime_s(&local, &tt);
 #else
-  local = *std::localtime(&tt);
+  localtime_r(&tt, &local);
 #endif
   const int currentYear = 1900 + local.tm_year;
   const int age = currentYear - vehicle.year;
 
-  auto oil = findPart(stock, "P001");
-  auto oilFilter = findPart(stock, "P002");
-  auto airFilter = findPart(stock, "P003");
-  auto brakePads = findPart(stock, "P004");
+  static const KnownPart kOil("P001"), kOilFilter("P002"), kAirFilter("P003"), kBrakePads("P004");
+  auto oil = findPart(stock, kOil);
+  auto oilFilter = findPart(stock, kOilFilter);
+  auto airFilter = findPart(stock, kAirFilter);
+  auto brakePads = findPart(stock, kBrakePads);
 
   std::vector<std::string> notes;
 
+  bool skipped = false;
   if (oil && oilFilter) {
-    result.items.push_back(makeItem("S-OIL", "Oil & Filter Change", 0.6, 35,
-                                     {{*oil, 4}, {*oilFilter, 1}}));
-    notes.push_back("Added oil and filter change");
+    if (auto done = recentlyDone(history, vehicle, "S-OIL", nowMs)) {
+      notes.push_back(skipNote("oil change", *done));
+      skipped = true;
+    } else {
+      result.items.push_back(makeItem("S-OIL", "Oil & Filter Change", 0.6, 35,
+                                       {{*oil, 4}, {*oilFilter, 1}}));
+      notes.push_back("Added oil and filter change");
+    }
   }
 
   if (age >= 3 && airFilter) {
-    result.items.push_back(makeItem("S-AIR", "Cabin Air Filter", 0.3, 20,
-                                     {{*airFilter, 1}}));
-    notes.push_back("Refreshed cabin air filter for vehicles older than 3 years");
+    if (auto done = recentlyDone(history, vehicle, "S-AIR", nowMs)) {
+      notes.push_back(skipNote("cabin air filter", *done));
+      skipped = true;
+    } else {
+      result.items.push_back(makeItem("S-AIR", "Cabin Air Filter", 0.3, 20,
+                                       {{*airFilter, 1}}));
+      notes.push_back("Refreshed cabin air filter for vehicles older than 3 years");
+    }
   }
 
   if (age >= 5 && brakePads) {
-    result.items.push_back(makeItem("S-BRAKE", "Brake Pad Inspection", 0.8, 45,
-                                     {{*brakePads, 1}}));
-    notes.push_back("Included brake pad check for 5+ year old vehicles");
+    if (auto done = recentlyDone(history, vehicle, "S-BRAKE", nowMs)) {
+      notes.push_back(skipNote("brake pad check", *done));
+      skipped = true;
+    } else {
+      result.items.push_back(makeItem("S-BRAKE", "Brake Pad Inspection", 0.8, 45,
+                                       {{*brakePads, 1}}));
+      notes.push_back("Included brake pad check for 5+ year old vehicles");
+    }
   }
 
-  if (result.items.empty()) {
+  if (result.items.empty() && skipped) {
+    result.items.push_back(makeItem("S-CHECK", "General Inspection", 0.5, 30, {}, true));
+    notes.push_back("General inspection only; scheduled services are not yet due");
+  } else if (result.items.empty()) {
     // Fallback when no parts are recognized
     result.items.push_back(makeItem("S-CHECK", "General Inspection", 0.5, 30, {}, true));
     notes.push_back("Fallback general inspection used (no matching parts found)");
@@ -74,6 +147,9 @@ DetectionResult MaintenanceDetector::detect(const Vehicle& vehicle, const std::v
     oss << notes[i];
   }
   result.note = oss.str();
+  static auto& proposed = MetricsRegistry::global().counter("auto_repair_detected_items_total",
+                                                            "Service items proposed by the detector");
+  proposed.inc(result.items.size());
   return result;
 }
 
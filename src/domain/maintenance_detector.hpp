@@ -4,16 +4,19 @@
 #include <vector>
 #include "vehicle.hpp"
 #include "work_order.hpp"
+#include "service_history.hpp"
 
 struct DetectionResult {
-  std::vector<WOItem> items;
+  WOItemList items;
   std::string note;
 };
 
 // A light-weight ruleset that inspects the vehicle and selects
-// maintenance packages + required parts.
+// maintenance packages + required parts. With a history, services done
+// within their interval (time or mileage) are skipped.
 class MaintenanceDetector {
 public:
-  static DetectionResult detect(const Vehicle& vehicle, const std::vector<Part>& stock);
+  static DetectionResult detect(const Vehicle& vehicle, const std::vector<Part>& stock,
+                                const ServiceHistory* history = nullptr);
 };
 
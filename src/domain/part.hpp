@@ -1,6 +1,7 @@
-
 #pragma once
+#include <cstdint>
 #include <string>
+#include "id_table.hpp"
 
 struct Part {
   std::string id;
@@ -9,4 +10,12 @@ struct Part {
   int stock{0};
   int reorderPoint{3};
   int capacity{0}; // maximum designed stock for alert threshold
+  IdHandle handle{kNoHandle}; // IdTable::parts() handle of id, kNoHandle until interned; fills padding
+  std::uint64_t version{0}; // bumped by every stock change
 };
+
+// The part's handle, looked up by id when the part does not carry one.
+// kNoHandle when the id was never interned, i.e. no inventory stocks it.
+inline IdHandle partHandle(const Part& p) {
+  return p.handle != kNoHandle ? p.handle : IdTable::parts().find(p.id);
+}
@@ -0,0 +1,111 @@
+#include "domain/search_index.hpp"
+
+#include <algorithm>
+
+namespace {
+std::string normalize(std::string_view s) {
+  std::string out(s);
+  for (auto& ch : out) {
+    if (ch >= 'A' && ch <= 'Z') ch = static_cast<char>(ch - 'A' + 'a');
+  }
+  return out;
+}
+
+std::uint32_t trigramAt(const std::string& s, std::size_t i) {
+  return static_cast<std::uint32_t>(static_cast<unsigned char>(s[i])) << 16 |
+         static_cast<std::uint32_t>(static_cast<unsigned char>(s[i + 1])) << 8 |
+         static_cast<std::uint32_t>(static_cast<unsigned char>(s[i + 2]));
+}
+}
+
+void SearchIndex::addVehicle(const Vehicle& v) {
+  add(SearchKind::Vehicle, v.vin, v.plate + " (" + v.vin + ")", {v.plate, v.vin});
+}
+
+void SearchIndex::addCustomer(const Customer& c) {
+  add(SearchKind::Customer, c.id, c.name + " (" + c.phone + ")", {c.name, c.phone});
+}
+
+void SearchIndex::addPart(const Part& p) {
+  add(SearchKind::Part, p.id, p.name + " (" + p.id + ")", {p.name});
+}
+
+void SearchIndex::add(SearchKind kind, const std::string& id, const std::string& label,
+                      std::initializer_list<std::string_view> fields) {
+  const auto doc = static_cast<std::uint32_t>(docs_.size());
+  Doc d{kind, id, label, {}};
+  for (auto field : fields) {
+    if (field.empty()) continue;
+    auto norm = normalize(field);
+    for (std::size_t i = 0; i + 3 <= norm.size(); ++i) {
+      auto& postings = trigrams_[trigramAt(norm, i)];
+      if (postings.empty() || postings.back() != doc) postings.push_back(doc);
+    }
+    if (!d.text.empty()) d.text += '\n';
+    d.text += norm;
+    prefixes_.emplace(std::move(norm), doc);
+  }
+  docs_.push_back(std::move(d));
+}
+
+std::vector<SearchHit> SearchIndex::search(std::string_view query, std::size_t limit) const {
+  auto q = normalize(query);
+  if (q.empty() || limit == 0) return {};
+  return q.size() < 3 ? searchPrefix(q, limit) : searchTrigrams(q, limit);
+}
+
+std::vector<SearchHit> SearchIndex::searchPrefix(const std::string& q, std::size_t limit) const {
+  std::vector<std::uint32_t> found;
+  for (auto it = prefixes_.lower_bound(q); it != prefixes_.end() && found.size() < limit; ++it) {
+    if (it->first.compare(0, q.size(), q) != 0) break;
+    // A document can match through more than one field
+    if (std::find(found.begin(), found.end(), it->second) == found.end()) found.push_back(it->second);
+  }
+  std::sort(found.begin(), found.end());
+  std::vector<SearchHit> hits;
+  hits.reserve(found.size());
+  for (auto doc : found) hits.push_back(hit(doc));
+  return hits;
+}
+
+std::vector<SearchHit> SearchIndex::searchTrigrams(const std::string& q, std::size_t limit) const {
+  std::vector<const std::vector<std::uint32_t>*> lists;
+  for (std::size_t i = 0; i + 3 <= q.size(); ++i) {
+    auto it = trigrams_.find(trigramAt(q, i));
+    if (it == trigrams_.end()) return {};
+    lists.push_back(&it->second);
+  }
+  std::sort(lists.begin(), lists.end(), [](auto* a, auto* b) { return a->size() < b->size(); });
+
+  // Walk the rarest trigram's list, advancing a cursor through each longer
+  // list as we go, so a query stops as soon as `limit` documents matched.
+  std::vector<std::vector<std::uint32_t>::const_iterator> cursors;
+  for (std::size_t l = 1; l < lists.size(); ++l) cursors.push_back(lists[l]->begin());
+
+  std::vector<SearchHit> hits;
+  for (auto doc : *lists.front()) {
+    bool inAll = true;
+    for (std::size_t l = 1; l < lists.size() && inAll; ++l) {
+      auto& at = cursors[l - 1];
+      at = std::lower_bound(at, lists[l]->end(), doc);
+      if (at == lists[l]->end()) return hits;
+      inAll = *at == doc;
+    }
+    // Trigrams can all occur without being contiguous
+    if (!inAll || docs_[doc].text.find(q) == std::string::npos) continue;
+    hits.push_back(hit(doc));
+    if (hits.size() == limit) break;
+  }
+  return hits;
+}
+
+SearchHit SearchIndex::hit(std::uint32_t doc) const {
+  const auto& d = docs_[doc];
+  return SearchHit{d.kind, d.id, d.label};
+}
+
+void SearchIndex::clear() {
+  docs_.clear();
+  trigrams_.clear();
+  prefixes_.clear();
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "customer.hpp"
+#include "part.hpp"
+#include "vehicle.hpp"
+
+enum class SearchKind { Vehicle, Customer, Part };
+
+struct SearchHit {
+  SearchKind kind;
+  std::string id; // VIN, customer id or part id
+  std::string label;
+};
+
+// In-memory lookup over plates, VINs, customer names/phones and part names.
+// Queries of three or more bytes are substring matches answered from a
+// trigram index; shorter queries match field prefixes. Entries are added
+// incrementally and matching is case-insensitive for ASCII.
+class SearchIndex {
+public:
+  void addVehicle(const Vehicle& v);
+  void addCustomer(const Customer& c);
+  void addPart(const Part& p);
+  void add(SearchKind kind, const std::string& id, const std::string& label,
+           std::initializer_list<std::string_view> fields);
+
+  // At most `limit` hits. Substring queries return the first matches in the
+  // order entries were added. Prefix queries take the first `limit` matching
+  // fields in sorted order, so they need not be the earliest entries, and
+  // return those entries in the order they were added.
+  std::vector<SearchHit> search(std::string_view query, std::size_t limit = 20) const;
+  std::size_t size() const { return docs_.size(); }
+  void clear();
+
+private:
+  struct Doc {
+    SearchKind kind;
+    std::string id;
+    std::string label;
+    std::string text; // normalized fields separated by '\n'
+  };
+
+  std::vector<Doc> docs_;
+  std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> trigrams_; // ascending doc ids
+  std::multimap<std::string, std::uint32_t> prefixes_;                     // normalized field -> doc
+
+  std::vector<SearchHit> searchPrefix(const std::string& q, std::size_t limit) const;
+  std::vector<SearchHit> searchTrigrams(const std::string& q, std::size_t limit) const;
+  SearchHit hit(std::uint32_t doc) const;
+};
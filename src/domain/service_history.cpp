@@ -0,0 +1,41 @@
+#include "domain/service_history.hpp"
+
+#include <algorithm>
+
+void ServiceHistory::record(const WorkOrder& order) {
+  if (order.status != WOStatus::Paid) return;
+  for (const auto& it : order.items) {
+    add(order.vehicle.vin, ServiceRecord{it.item.id, order.id, order.closedAt, order.vehicle.mileage});
+  }
+}
+
+void ServiceHistory::add(const std::string& vin, const ServiceRecord& rec) {
+  if (vin.empty() || rec.serviceId.empty()) return;
+  auto& list = byService_[{vin, rec.serviceId}];
+  bool seen = std::any_of(list.begin(), list.end(), [&](const ServiceRecord& r){ return r.workOrderId == rec.workOrderId; });
+  if (seen) return;
+  auto pos = std::upper_bound(list.begin(), list.end(), rec.completedAt,
+                              [](std::int64_t t, const ServiceRecord& r){ return t < r.completedAt; });
+  list.insert(pos, rec);
+}
+
+std::optional<ServiceRecord> ServiceHistory::last(const std::string& vin, const std::string& serviceId) const {
+  auto it = byService_.find({vin, serviceId});
+  if (it == byService_.end() || it->second.empty()) return std::nullopt;
+  return it->second.back();
+}
+
+std::vector<ServiceRecord> ServiceHistory::forVehicle(const std::string& vin) const {
+  std::vector<ServiceRecord> out;
+  for (auto it = byService_.lower_bound({vin, std::string()}); it != byService_.end() && it->first.first == vin; ++it) {
+    out.insert(out.end(), it->second.begin(), it->second.end());
+  }
+  std::stable_sort(out.begin(), out.end(), [](const ServiceRecord& a, const ServiceRecord& b){ return a.completedAt < b.completedAt; });
+  return out;
+}
+
+void ServiceHistory::forEach(const std::function<void(const std::string&, const ServiceRecord&)>& fn) const {
+  for (const auto& [key, list] : byService_) {
+    for (const auto& rec : list) fn(key.first, rec);
+  }
+}
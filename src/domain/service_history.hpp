@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "work_order.hpp"
+
+struct ServiceRecord {
+  std::string serviceId;
+  std::string workOrderId;
+  std::int64_t completedAt{0}; // epoch ms
+  int mileage{0};              // odometer when the order was opened
+};
+
+// Per-VIN index of completed service, maintained as orders settle and
+// persisted with the data store so it never needs a rescan of old orders.
+class ServiceHistory {
+public:
+  // Adds one record per service item of a paid order; re-recording is a no-op.
+  void record(const WorkOrder& order);
+  void add(const std::string& vin, const ServiceRecord& rec);
+
+  // Most recent record of a service for a vehicle, O(log n).
+  std::optional<ServiceRecord> last(const std::string& vin, const std::string& serviceId) const;
+  // All records for a vehicle, oldest first.
+  std::vector<ServiceRecord> forVehicle(const std::string& vin) const;
+
+  void forEach(const std::function<void(const std::string& vin, const ServiceRecord&)>& fn) const;
+  bool empty() const { return byService_.empty(); }
+
+private:
+  // (vin, serviceId) -> records ordered by completedAt
+  std::map<std::pair<std::string, std::string>, std::vector<ServiceRecord>> byService_;
+};
@@ -10,4 +10,5 @@ struct Vehicle {
   std::string model;
   int year{0};
   std::string ownerId;
+  int mileage{0}; // odometer in km at the latest check-in
 };
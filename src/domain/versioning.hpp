@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+// Optimistic concurrency: work orders and parts carry a version that every
+// change bumps. A writer passes the version it last read; if the entity has
+// moved on since, the update is refused with VersionConflict instead of
+// silently overwriting the other writer's change.
+enum class Versioned { WorkOrder, Part };
+
+class VersionConflict : public std::runtime_error {
+public:
+  VersionConflict(Versioned entity, const std::string& id, std::uint64_t expected, std::uint64_t actual)
+      : std::runtime_error((entity == Versioned::WorkOrder ? "Work order " : "Part ") + id +
+                           " was changed by someone else (version " + std::to_string(actual) +
+                           ", expected " + std::to_string(expected) + ")"),
+        entity(entity), id(id), expected(expected), actual(actual) {}
+
+  Versioned entity;
+  std::string id;
+  std::uint64_t expected;
+  std::uint64_t actual;
+};
+
+// Throws VersionConflict unless `expected` is empty or matches `actual`.
+inline void checkVersion(Versioned entity, const std::string& id, std::optional<std::uint64_t> expected,
+                         std::uint64_t actual) {
+  if (expected && *expected != actual) throw VersionConflict(entity, id, *expected, actual);
+}
+
+struct ConflictCounters {
+  std::atomic<std::uint64_t> checks{0};    // updates that carried an expected version
+  std::atomic<std::uint64_t> conflicts{0}; // ... and found it stale
+  std::atomic<std::uint64_t> retries{0};   // attempts repeated by retryOnConflict
+  std::atomic<std::uint64_t> exhausted{0}; // retry loops that gave up
+};
+
+// Conflict counters per entity type; safe to bump from any thread.
+class ConflictMetrics {
+  ConflictCounters workOrders_;
+  ConflictCounters parts_;
+public:
+  ConflictCounters& of(Versioned entity) { return entity == Versioned::WorkOrder ? workOrders_ : parts_; }
+  const ConflictCounters& of(Versioned entity) const { return entity == Versioned::WorkOrder ? workOrders_ : parts_; }
+};
+
+// Runs `attempt` until it gets through without a VersionConflict, at most
+// `maxAttempts` times. `attempt` must re-read the current version each time.
+// The last conflict is rethrown when every attempt lost.
+template <class Attempt>
+auto retryOnConflict(Attempt&& attempt, int maxAttempts = 3, ConflictMetrics* metrics = nullptr) -> decltype(attempt()) {
+  for (int tries = 1;; ++tries) {
+    try {
+      return attempt();
+    } catch (const VersionConflict& conflict) {
+      if (tries >= maxAttempts) {
+        if (metrics) ++metrics->of(conflict.entity).exhausted;
+        throw;
+      }
+      if (metrics) ++metrics->of(conflict.entity).retries;
+    }
+  }
+}
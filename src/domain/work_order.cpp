@@ -4,7 +4,7 @@
 
 WorkOrder::WorkOrder(const WorkOrder& other)
   : id(other.id), vehicle(other.vehicle), advisor(other.advisor), tech(other.tech), customer(other.customer),
-    items(other.items), status(other.status), detectionNote(other.detectionNote),
+    items(other.items), pendingItems(other.pendingItems), cachedTotal(other.cachedTotal), status(other.status), closedAt(other.closedAt), lifecycle(other.lifecycle), version(other.version), partsConsumed(other.partsConsumed), detectionNote(other.detectionNote),
     pricing(other.pricing ? other.pricing->clone() : std::make_unique<NormalPricing>()) {}
 
 WorkOrder& WorkOrder::operator=(const WorkOrder& other) {
@@ -15,13 +15,19 @@ WorkOrder& WorkOrder::operator=(const WorkOrder& other) {
   tech = other.tech;
   customer = other.customer;
   items = other.items;
+  pendingItems = other.pendingItems;
+  cachedTotal = other.cachedTotal;
   status = other.status;
+  closedAt = other.closedAt;
+  lifecycle = other.lifecycle;
+  version = other.version;
+  partsConsumed = other.partsConsumed;
   detectionNote = other.detectionNote;
   pricing = other.pricing ? other.pricing->clone() : std::make_unique<NormalPricing>();
   return *this;
 }
 
-static double compute_sum(const std::vector<WOItem>& items, double techHourly) {
+static double compute_sum(const WOItemList& items, double techHourly) {
   double total = 0;
   for (const auto& it : items) {
     double h = (it.laborHoursOverride > 0 ? it.laborHoursOverride : it.item.laborHours);
@@ -31,37 +37,58 @@ static double compute_sum(const std::vector<WOItem>& items, double techHourly) {
   return total;
 }
 
-double NormalPricing::calcTotal(const std::vector<WOItem>& items, double techHourly) const {
+double NormalPricing::calcTotal(const WOItemList& items, double techHourly) const {
   return compute_sum(items, techHourly);
 }
-double MemberDiscountPricing::calcTotal(const std::vector<WOItem>& items, double techHourly) const {
+double MemberDiscountPricing::calcTotal(const WOItemList& items, double techHourly) const {
   return compute_sum(items, techHourly) * rate_;
 }
-double CampaignPricing::calcTotal(const std::vector<WOItem>& items, double techHourly) const {
+double CampaignPricing::calcTotal(const WOItemList& items, double techHourly) const {
   return compute_sum(items, techHourly) * rate_;
 }
 
 void WorkOrder::assign(const Technician& t) {
-  if (status != WOStatus::Draft) throw std::runtime_error("Can only assign in Draft");
+  if (status != WOStatus::Draft && status != WOStatus::Assigned) {
+    throw std::runtime_error("Can only assign before work starts");
+  }
   tech = t;
-  if (!id.empty()) tech.assignedWorkOrders.push_back(id);
-  status = WOStatus::Assigned;
+  if (!id.empty()) tech.assignedWorkOrders.push_back(IdTable::workOrders().intern(id));
+  // A reassignment keeps the original assignment time
+  if (status == WOStatus::Draft) {
+    status = WOStatus::Assigned;
+    lifecycle.assigned = StageStamp::now();
+  }
+  ++version;
 }
 void WorkOrder::start() {
   if (status != WOStatus::Assigned) throw std::runtime_error("Can only start after Assigned");
   status = WOStatus::InProgress;
+  lifecycle.started = StageStamp::now();
+  ++version;
 }
 void WorkOrder::complete() {
   if (status != WOStatus::InProgress) throw std::runtime_error("Can only complete after InProgress");
   status = WOStatus::Completed;
+  lifecycle.completed = StageStamp::now();
+  ++version;
 }
 double WorkOrder::previewTotal() const {
+  if (!hydrated()) return cachedTotal;
   double techHourly = tech.hourlyRate;
   return pricing->calcTotal(items, techHourly);
 }
+double WorkOrder::laborHours(const WOItemList& items) {
+  double hours = 0;
+  for (const auto& it : items) hours += (it.laborHoursOverride > 0 ? it.laborHoursOverride : it.item.laborHours);
+  return hours;
+}
 double WorkOrder::settle() {
   if (status != WOStatus::Completed) throw std::runtime_error("Cannot settle before Completed");
+  if (!hydrated()) throw std::runtime_error("Cannot settle before items are loaded");
   double total = previewTotal();
   status = WOStatus::Paid;
+  lifecycle.settled = StageStamp::now();
+  closedAt = lifecycle.settled.wallMs;
+  ++version;
   return total;
 }
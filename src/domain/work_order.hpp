@@ -3,46 +3,85 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <memory_resource>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
 #include "customer.hpp"
 #include "vehicle.hpp"
 #include "employee.hpp"
 #include "part.hpp"
 #include "service_item.hpp"
+#include "lifecycle.hpp"
 
 enum class WOStatus { Draft, Assigned, InProgress, Completed, Paid, Cancelled };
 
+inline bool isClosed(WOStatus st) { return st == WOStatus::Paid || st == WOStatus::Cancelled; }
+
+// Items and their part lines are allocator-aware, so an order's items can
+// be built in its store's ItemArena: a pmr vector of WOItem passes its
+// memory resource on to each item's parts.
+using PartLines = std::pmr::vector<std::pair<Part, int>>; // (part, qty)
+
 struct WOItem {
+  using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
   ServiceItem item;
-  std::vector<std::pair<Part, int>> parts; // (part, qty)
+  PartLines parts;
   double laborHoursOverride{-1};
   bool autoDetected{false};
+
+  WOItem() = default;
+  explicit WOItem(const allocator_type& alloc) : parts(alloc) {}
+  WOItem(const WOItem&) = default;
+  WOItem(WOItem&&) = default;
+  WOItem(const WOItem& other, const allocator_type& alloc)
+      : item(other.item), parts(other.parts, alloc), laborHoursOverride(other.laborHoursOverride),
+        autoDetected(other.autoDetected) {}
+  WOItem(WOItem&& other, const allocator_type& alloc)
+      : item(std::move(other.item)), parts(std::move(other.parts), alloc),
+        laborHoursOverride(other.laborHoursOverride), autoDetected(other.autoDetected) {}
+  WOItem& operator=(const WOItem&) = default;
+  WOItem& operator=(WOItem&&) = default;
+};
+
+using WOItemList = std::pmr::vector<WOItem>;
+
+// Byte range of a work order's serialized items inside a buffer holding
+// only the item arrays of the file it was loaded from. Header-only loads keep
+// this instead of decoded WOItems; the buffer is freed with the last
+// pending order.
+struct PendingItems {
+  std::shared_ptr<const std::string> source;
+  std::size_t offset{0};
+  std::size_t length{0};
 };
 
 class PricingStrategy {
 public:
   virtual ~PricingStrategy() = default;
   virtual std::unique_ptr<PricingStrategy> clone() const = 0;
-  virtual double calcTotal(const std::vector<WOItem>& items, double techHourly) const = 0;
+  virtual double calcTotal(const WOItemList& items, double techHourly) const = 0;
 };
 
 class NormalPricing final : public PricingStrategy {
 public:
   std::unique_ptr<PricingStrategy> clone() const override { return std::make_unique<NormalPricing>(*this); }
-  double calcTotal(const std::vector<WOItem>& items, double techHourly) const override;
+  double calcTotal(const WOItemList& items, double techHourly) const override;
 };
 class MemberDiscountPricing final : public PricingStrategy {
   double rate_{0.9};
 public:
   explicit MemberDiscountPricing(double rate=0.9): rate_(rate) {}
   std::unique_ptr<PricingStrategy> clone() const override { return std::make_unique<MemberDiscountPricing>(*this); }
-  double calcTotal(const std::vector<WOItem>& items, double techHourly) const override;
+  double calcTotal(const WOItemList& items, double techHourly) const override;
 };
 class CampaignPricing final : public PricingStrategy {
   double rate_{0.8};
 public:
   explicit CampaignPricing(double rate=0.8): rate_(rate) {}
   std::unique_ptr<PricingStrategy> clone() const override { return std::make_unique<CampaignPricing>(*this); }
-  double calcTotal(const std::vector<WOItem>& items, double techHourly) const override;
+  double calcTotal(const WOItemList& items, double techHourly) const override;
 };
 
 class WorkOrder {
@@ -54,19 +93,31 @@ public:
   Customer customer;
   std::string detectionNote;
 
-  std::vector<WOItem> items;
+  WOItemList items; // copies use the default heap, moves keep the source's resource
+  std::optional<PendingItems> pendingItems; // set until DataStorePersistence::hydrate
+  double cachedTotal{0}; // total saved with the header, reported while items are pending
   WOStatus status{WOStatus::Draft};
+  std::int64_t closedAt{0}; // epoch ms when the order was paid or cancelled
+  Lifecycle lifecycle;
+  std::uint64_t version{0}; // bumped by every lifecycle transition
+  bool partsConsumed{false}; // settlement took the parts out of stock
   std::unique_ptr<PricingStrategy> pricing{std::make_unique<NormalPricing>()};
 
   WorkOrder() = default;
+  // Items are allocated from `itemResource`, typically a store's ItemArena.
+  explicit WorkOrder(std::pmr::memory_resource* itemResource) : items(itemResource) {}
   WorkOrder(const WorkOrder& other);
   WorkOrder& operator=(const WorkOrder& other);
   WorkOrder(WorkOrder&&) noexcept = default;
-  WorkOrder& operator=(WorkOrder&&) noexcept = default;
+  // Not noexcept: between different item resources the items are copied
+  WorkOrder& operator=(WorkOrder&&) = default;
 
   void assign(const Technician& t);
   void start();
   void complete();
   double settle(); // sets status to Paid and returns total
   double previewTotal() const; // helper
+  double laborHours() const { return laborHours(items); } // billed labor, honoring per-item overrides
+  static double laborHours(const WOItemList& items);
+  bool hydrated() const { return !pendingItems; }
 };
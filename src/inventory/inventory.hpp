@@ -1,49 +1,105 @@
 
 #pragma once
-#include <unordered_map>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <optional>
 #include <stdexcept>
 #include <cmath>
+#include "domain/id_table.hpp"
 #include "domain/part.hpp"
+#include "domain/versioning.hpp"
 #include "observer.hpp"
 
+// Parts are stored packed in insertion order and found through a slot table
+// indexed by their IdTable::parts() handle, so a lookup by handle is two
+// array reads. Lookups by string id resolve the handle first.
 class Inventory {
-  std::unordered_map<std::string, Part> parts_;
+  static constexpr std::uint32_t kNoSlot = UINT32_MAX;
+  std::vector<Part> parts_;
+  std::vector<std::uint32_t> slots_; // part handle -> index into parts_
   std::vector<InventoryObserver*> obs_;
+
+  Part* slot(IdHandle handle) {
+    return handle < slots_.size() && slots_[handle] != kNoSlot ? &parts_[slots_[handle]] : nullptr;
+  }
+  const Part* slot(IdHandle handle) const {
+    return handle < slots_.size() && slots_[handle] != kNoSlot ? &parts_[slots_[handle]] : nullptr;
+  }
+  Part* slot(const std::string& id) { return slot(IdTable::parts().find(id)); }
+  const Part* slot(const std::string& id) const { return slot(IdTable::parts().find(id)); }
 public:
   void addObserver(InventoryObserver* o) { obs_.push_back(o); }
-  void upsert(const Part& p) { parts_[p.id] = p; }
-  bool has(const std::string& id) const { return parts_.count(id) > 0; }
+  void upsert(const Part& p) {
+    const auto handle = IdTable::parts().intern(p.id);
+    if (handle >= slots_.size()) slots_.resize(handle + 1, kNoSlot);
+    if (slots_[handle] == kNoSlot) {
+      slots_[handle] = static_cast<std::uint32_t>(parts_.size());
+      parts_.push_back(p);
+    } else {
+      parts_[slots_[handle]] = p;
+    }
+    parts_[slots_[handle]].handle = handle;
+  }
+  bool has(const std::string& id) const { return slot(id) != nullptr; }
+  bool has(IdHandle handle) const { return slot(handle) != nullptr; }
   Part get(const std::string& id) const {
-    auto it = parts_.find(id);
-    if (it == parts_.end()) throw std::runtime_error("part not found");
-    return it->second;
+    const auto* part = slot(id);
+    if (!part) throw std::runtime_error("part not found");
+    return *part;
   }
   std::optional<Part> find(const std::string& id) const {
-    auto it = parts_.find(id);
-    if (it == parts_.end()) return std::nullopt;
-    return it->second;
-  }
-  std::vector<Part> list() const {
-    std::vector<Part> out;
-    out.reserve(parts_.size());
-    for (const auto& kv : parts_) out.push_back(kv.second);
-    return out;
-  }
-  bool consume(const std::string& id, int qty) {
-    auto it = parts_.find(id);
-    if (it == parts_.end() || it->second.stock < qty) return false;
-    it->second.stock -= qty;
-    bool lowByReorder = it->second.stock <= it->second.reorderPoint;
+    const auto* part = slot(id);
+    if (!part) return std::nullopt;
+    return *part;
+  }
+  std::optional<Part> find(IdHandle handle) const {
+    const auto* part = slot(handle);
+    if (!part) return std::nullopt;
+    return *part;
+  }
+  // The stocked part without a copy; null when unknown. Invalidated by upsert.
+  const Part* lookup(IdHandle handle) const { return slot(handle); }
+  template <class F>
+  void forEach(F&& f) const {
+    for (const auto& p : parts_) f(p.id, p);
+  }
+  std::size_t size() const { return parts_.size(); }
+  std::size_t capacity() const { return parts_.capacity(); }
+  std::size_t slotCount() const { return slots_.capacity(); }
+  std::vector<Part> list() const { return parts_; }
+  // Stock writes return false for an unknown part and throw VersionConflict
+  // when `expectedVersion` is given and stale.
+  bool restock(const std::string& id, int qty, std::optional<std::uint64_t> expectedVersion = std::nullopt) {
+    auto* part = slot(id);
+    if (!part) return false;
+    checkVersion(Versioned::Part, id, expectedVersion, part->version);
+    part->stock += qty;
+    ++part->version;
+    return true;
+  }
+  bool setStock(const std::string& id, int stock, std::optional<std::uint64_t> expectedVersion = std::nullopt) {
+    auto* part = slot(id);
+    if (!part) return false;
+    checkVersion(Versioned::Part, id, expectedVersion, part->version);
+    part->stock = stock;
+    ++part->version;
+    return true;
+  }
+  bool consume(const std::string& id, int qty) { return consume(IdTable::parts().find(id), qty); }
+  bool consume(IdHandle handle, int qty) {
+    auto* part = slot(handle);
+    if (!part || part->stock < qty) return false;
+    part->stock -= qty;
+    ++part->version;
+    bool lowByReorder = part->stock <= part->reorderPoint;
     bool lowByCapacity = false;
-    if (it->second.capacity > 0) {
-      auto threshold = static_cast<int>(std::ceil(it->second.capacity * 0.1));
-      lowByCapacity = it->second.stock <= threshold;
+    if (part->capacity > 0) {
+      auto threshold = static_cast<int>(std::ceil(part->capacity * 0.1));
+      lowByCapacity = part->stock <= threshold;
     }
     if (lowByReorder || lowByCapacity) {
-      for (auto* o : obs_) o->onLowStock(id, it->second.stock);
+      for (auto* o : obs_) o->onLowStock(part->id, part->stock);
     }
     return true;
   }
@@ -1,8 +1,19 @@
 #include "inventory/store_house.hpp"
+#include "metrics/metrics_registry.hpp"
+#include "trace/tracer.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <iterator>
 #include <sstream>
 
+namespace {
+Counter& consumeOutcome(const char* outcome) {
+  return MetricsRegistry::global().counter("auto_repair_storehouse_consume_total",
+                                           "Orders whose parts were taken (ok) or refused (stockout)", {{"outcome", outcome}});
+}
+}
+
 StoreHouse::StoreHouse() {
   inventory_.addObserver(this);
 }
@@ -11,52 +22,131 @@ StoreHouse::StoreHouse(const std::vector<Part>& seedParts) : StoreHouse() {
   seed(seedParts);
 }
 
+std::unique_lock<std::mutex> StoreHouse::lock() const {
+  acquisitions_.fetch_add(1, std::memory_order_relaxed);
+  std::unique_lock<std::mutex> guard(mutex_, std::try_to_lock);
+  if (!guard.owns_lock()) {
+    const auto start = std::chrono::steady_clock::now();
+    guard.lock();
+    const auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    contended_.fetch_add(1, std::memory_order_relaxed);
+    waitNs_.fetch_add(static_cast<std::uint64_t>(waited.count()), std::memory_order_relaxed);
+  }
+  return guard;
+}
+
 void StoreHouse::seed(const std::vector<Part>& parts) {
+  auto guard = lock();
   for (const auto& p : parts) {
     inventory_.upsert(p);
   }
 }
 
 std::vector<Part> StoreHouse::snapshot() const {
+  auto guard = lock();
   return inventory_.list();
 }
 
 bool StoreHouse::consume(const std::string& partId, int qty) {
+  auto guard = lock();
   return inventory_.consume(partId, qty);
 }
 
-bool StoreHouse::consumeForOrder(const WorkOrder& order) {
-  bool ok = true;
-  // Pre-flight check to ensure all parts exist and have enough stock
+bool StoreHouse::consumeForOrder(const WorkOrder& order, std::vector<std::string>* alerts) {
+  TRACE_SCOPE("storehouse.consumeForOrder");
+  // A part can appear in several items, so quantities are totalled per part
+  // before the check; otherwise the first lines could be taken and a later
+  // one refused.
+  std::vector<std::pair<IdHandle, int>> wanted;
   for (const auto& item : order.items) {
     for (const auto& pair : item.parts) {
-      auto existing = inventory_.find(pair.first.id);
-      if (!existing || existing->stock < pair.second) {
-        ok = false;
+      const auto handle = partHandle(pair.first);
+      auto it = std::find_if(wanted.begin(), wanted.end(), [&](const auto& w) { return w.first == handle; });
+      if (it == wanted.end()) {
+        wanted.emplace_back(handle, pair.second);
+      } else {
+        it->second += pair.second;
       }
     }
   }
-  if (!ok) return false;
+  auto guard = lock();
+  bool ok = true;
+  // Pre-flight check to ensure all parts exist and have enough stock
+  for (const auto& [handle, qty] : wanted) {
+    const auto* existing = inventory_.lookup(handle);
+    if (!existing || existing->stock < qty) {
+      ok = false;
+    }
+  }
+  static auto& consumed = consumeOutcome("ok");
+  static auto& refused = consumeOutcome("stockout");
+  if (!ok) {
+    stockouts_.fetch_add(1, std::memory_order_relaxed);
+    refused.inc();
+    return false;
+  }
 
-  for (const auto& item : order.items) {
-    for (const auto& pair : item.parts) {
-      if (!consume(pair.first.id, pair.second)) {
-        ok = false;
-      }
+  const auto queued = alerts_.size();
+  for (const auto& [handle, qty] : wanted) {
+    if (!inventory_.consume(handle, qty)) {
+      ok = false;
     }
   }
+  if (alerts) {
+    const auto raised = alerts_.begin() + static_cast<std::ptrdiff_t>(queued);
+    alerts->insert(alerts->end(), std::make_move_iterator(raised), std::make_move_iterator(alerts_.end()));
+    alerts_.erase(raised, alerts_.end());
+  }
+  consumed.inc();
   return ok;
 }
 
+bool StoreHouse::receive(const std::string& partId, int qty, std::optional<std::uint64_t> expectedVersion) {
+  auto guard = lock();
+  return inventory_.restock(partId, qty, expectedVersion);
+}
+
+bool StoreHouse::adjust(const std::string& partId, int delta) {
+  auto guard = lock();
+  auto part = inventory_.find(partId);
+  if (!part) return false;
+  if (part->stock + delta < 0) throw std::runtime_error("Not enough stock of " + partId);
+  return inventory_.setStock(partId, part->stock + delta);
+}
+
+bool StoreHouse::setStock(const std::string& partId, int stock, std::optional<std::uint64_t> expectedVersion) {
+  auto guard = lock();
+  return inventory_.setStock(partId, stock, expectedVersion);
+}
+
+std::optional<Part> StoreHouse::find(const std::string& partId) const {
+  auto guard = lock();
+  return inventory_.find(partId);
+}
+
+std::optional<Part> StoreHouse::find(IdHandle part) const {
+  auto guard = lock();
+  return inventory_.find(part);
+}
+
 std::vector<std::string> StoreHouse::takeAlerts() {
-  auto copy = alerts_;
+  auto guard = lock();
+  auto copy = std::move(alerts_);
   alerts_.clear();
   return copy;
 }
 
+StoreHouseStats StoreHouse::stats() const {
+  return {acquisitions_.load(std::memory_order_relaxed), contended_.load(std::memory_order_relaxed),
+          waitNs_.load(std::memory_order_relaxed), stockouts_.load(std::memory_order_relaxed)};
+}
+
+// Called by the inventory with the mutex held
 void StoreHouse::onLowStock(const std::string& partId, int stock) {
+  static auto& lowStock = MetricsRegistry::global().counter("auto_repair_low_stock_alerts_total",
+                                                            "Consumptions that left a part at or below its alert level");
+  lowStock.inc();
   std::ostringstream oss;
   oss << "Part " << partId << " low stock: " << stock;
   alerts_.push_back(oss.str());
 }
-
@@ -1,28 +1,77 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 #include <string>
 #include <vector>
 #include "inventory.hpp"
 #include "domain/work_order.hpp"
 
+struct StoreHouseStats {
+  std::uint64_t acquisitions{0}; // lock acquisitions
+  std::uint64_t contended{0};    // acquisitions that had to wait
+  std::uint64_t waitNs{0};       // total time spent waiting
+  std::uint64_t stockouts{0};    // orders refused for lack of stock
+};
+
 // Centralized inventory house that keeps track of parts, consumption,
 // and low-stock alerts.
+//
+// Safe to share between threads: every operation holds one mutex, so an
+// order's parts are checked and taken as a unit. Observers are notified
+// while it is held and must not call back into the storehouse.
 class StoreHouse : public InventoryObserver {
 public:
   StoreHouse();
   explicit StoreHouse(const std::vector<Part>& seedParts);
 
   void seed(const std::vector<Part>& parts);
+  // Not synchronized; register observers before sharing the storehouse.
   void addObserver(InventoryObserver* obs) { inventory_.addObserver(obs); }
   std::vector<Part> snapshot() const;
+  // Visits (id, part) without copying, holding the lock throughout.
+  template <class F>
+  void forEachPart(F&& f) const {
+    auto guard = lock();
+    inventory_.forEach(f);
+  }
+  // Bytes of the inventory's part array and handle slot table
+  std::size_t indexBytes() const {
+    auto guard = lock();
+    return inventory_.capacity() * sizeof(Part) + inventory_.slotCount() * sizeof(std::uint32_t);
+  }
   bool consume(const std::string& partId, int qty);
-  bool consumeForOrder(const WorkOrder& order);
+  // Takes all of the order's parts or, when any is short, none of them.
+  // With `alerts`, the low-stock alerts this order raised are moved there
+  // instead of the shared queue, so concurrent callers get only their own.
+  bool consumeForOrder(const WorkOrder& order, std::vector<std::string>* alerts = nullptr);
+  // Adds delivered stock; false for an unknown part. A given
+  // `expectedVersion` must match the part's, or VersionConflict is thrown.
+  bool receive(const std::string& partId, int qty, std::optional<std::uint64_t> expectedVersion = std::nullopt);
+  // Adds `delta` (which may be negative) to the stock, checking and writing
+  // under one lock so concurrent writers cannot interleave. False for an
+  // unknown part; throws std::runtime_error if stock would go below zero.
+  bool adjust(const std::string& partId, int delta);
+  // Overwrites the counted stock, e.g. after a stock-take.
+  bool setStock(const std::string& partId, int stock, std::optional<std::uint64_t> expectedVersion = std::nullopt);
+  std::optional<Part> find(const std::string& partId) const;
+  std::optional<Part> find(IdHandle part) const;
+  // Drains the shared queue of alerts raised without an alert list
   std::vector<std::string> takeAlerts();
+  StoreHouseStats stats() const;
 
   void onLowStock(const std::string& partId, int stock) override;
 
 private:
   Inventory inventory_;
   std::vector<std::string> alerts_;
-};
+  mutable std::mutex mutex_;
+  mutable std::atomic<std::uint64_t> acquisitions_{0};
+  mutable std::atomic<std::uint64_t> contended_{0};
+  mutable std::atomic<std::uint64_t> waitNs_{0};
+  std::atomic<std::uint64_t> stockouts_{0};
 
+  // Takes the mutex, counting the acquisition and any wait for it
+  std::unique_lock<std::mutex> lock() const;
+};
@@ -1,69 +1,120 @@
 
 #include <QApplication>
 #include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
 #include "ui/gui.hpp"
 #include "persistence/data_store_persistence.hpp"
-#include "persistence/file_repository.hpp"
 #include "domain/maintenance_detector.hpp"
+#include "report/report_service.hpp"
+#include "report/report_exporter.hpp"
+#include "report/payroll.hpp"
+#include "report/memory_footprint.hpp"
+#include "report/allocation_counter.hpp"
+#include "persistence/work_order_archive.hpp"
+#include "metrics/metrics_file_writer.hpp"
+#include "trace/tracer.hpp"
+
+namespace {
+bool parseDay(const char* text, int& day) {
+  int y = 0, m = 0, d = 0;
+  if (std::sscanf(text, "%d-%d-%d", &y, &m, &d) != 3) return false;
+  day = TurnoverRollup::dayFromDate(y, m, d);
+  return true;
+}
+}
 
 int main(int argc, char* argv[]) {
-  QApplication app(argc, argv);
+  Tracer::installFromEnvironment();
+  MetricsFileWriter::installFromEnvironment();
+  Tracer::setThreadName("gui");
   const std::string dataPath = "data/data_store.json";
-  DataStore store = DataStorePersistence::load(dataPath);
-  if (store.customers.empty() && store.vehicles.empty() && store.workOrders.empty()) {
-    Customer c1{"C001", "Alice", "1380000", 1};
-    Customer c2{"C002", "Bob", "1370000", 0};
-    store.customers.push_back(c1);
-    store.customers.push_back(c2);
-
-    Vehicle v1{"VIN123", "渝A88888", "Toyota", "Corolla", 2020, c1.id};
-    Vehicle v2{"VIN456", "渝B66666", "Honda", "Civic", 2021, c2.id};
-    store.vehicles.push_back(v1);
-    store.vehicles.push_back(v2);
-
-    Technician t1; t1.id = "E100"; t1.name = "Bob"; t1.hourlyRate = 120; t1.hoursWorked = 8;
-    Technician t2; t2.id = "E101"; t2.name = "Charlie"; t2.hourlyRate = 150; t2.hoursWorked = 6;
-    store.technicians.push_back(t1);
-    store.technicians.push_back(t2);
-
-    PartCsvRepository partRepo("data/parts.csv");
-    auto parts = partRepo.findAll();
-    if (parts.empty()) {
-      Part oil{"P001","Engine Oil",50,30,5,100};
-      Part filter{"P002","Oil Filter",30,25,4,80};
-      Part air{"P003","Air Filter",45,18,3,60};
-      Part brake{"P004","Brake Pads",120,10,2,40};
-      partRepo.save(oil);
-      partRepo.save(filter);
-      partRepo.save(air);
-      partRepo.save(brake);
-      parts = partRepo.findAll();
+  if (argc > 1 && std::string(argv[1]) == "--latency-report") {
+    // Histograms are persisted, so no order needs decoding
+    auto store = DataStorePersistence::load(dataPath, DataStorePersistence::LoadMode::HeadersOnly);
+    store.lifecycleStats.writeCsv(std::cout);
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "--memory-report") {
+    // Loads the way the GUI does unless --full asks for every order's items
+    const bool full = argc > 2 && std::string(argv[2]) == "--full";
+    const auto heapBefore = AllocationCounter::liveBytes();
+    auto store = DataStorePersistence::load(dataPath, full ? DataStorePersistence::LoadMode::Full
+                                                           : DataStorePersistence::LoadMode::HeadersOnly);
+    StoreHouse storeHouse(store.parts);
+    const auto report = MemoryFootprint::measure(store, &storeHouse);
+    report.writeTable(std::cout);
+    if (AllocationCounter::enabled()) {
+      std::cout << "heap in use after loading: " << AllocationCounter::liveBytes() - heapBefore
+                << " bytes (includes derived indexes)" << std::endl;
     }
-    store.parts = parts;
-
-    WorkOrder wo;
-    wo.id = "WO0001";
-    wo.vehicle = v1;
-    wo.customer = c1;
-    wo.advisor.id = "E200";
-    wo.advisor.name = "Eve";
-    auto detection = MaintenanceDetector::detect(v1, store.parts);
-    wo.items = detection.items;
-    wo.detectionNote = detection.note;
-    wo.assign(t1);
-    auto techIt = std::find_if(store.technicians.begin(), store.technicians.end(), [&](const Technician& t){ return t.id == t1.id; });
-    if (techIt != store.technicians.end()) techIt->assignedWorkOrders.push_back(wo.id);
-    wo.start();
-    wo.complete();
-    wo.settle();
-    store.workOrders.push_back(wo);
-    DataStorePersistence::save(store, dataPath);
-  } else if (store.parts.empty()) {
-    PartCsvRepository partRepo("data/parts.csv");
-    store.parts = partRepo.findAll();
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "--export-report") {
+    if (argc < 3) {
+      std::cerr << "usage: auto_repair --export-report <file.csv|file.json>" << std::endl;
+      return 2;
+    }
+    auto store = DataStorePersistence::load(dataPath, DataStorePersistence::LoadMode::HeadersOnly);
+    WorkOrderArchive archive(WorkOrderArchive::directoryFor(dataPath));
+    if (!ReportExporter::exportTo(argv[2], store, &archive)) {
+      std::cerr << "cannot write " << argv[2] << std::endl;
+      return 1;
+    }
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "--top") {
+    const std::size_t k = argc > 2 ? static_cast<std::size_t>(std::max(1, std::atoi(argv[2]))) : 10;
+    auto store = DataStorePersistence::load(dataPath, DataStorePersistence::LoadMode::HeadersOnly);
+    auto print = [](const char* kind, const std::vector<RankedEntry>& list) {
+      for (std::size_t i = 0; i < list.size(); ++i) {
+        std::cout << kind << ',' << i + 1 << ',' << list[i].key << ',' << list[i].value << '\n';
+      }
+    };
+    std::cout << "kind,rank,id,value\n";
+    print("part_qty", ReportService::topParts(store.topN, k));
+    print("customer_revenue", ReportService::topCustomers(store.topN, k));
+    print("technician_orders", ReportService::topTechnicians(store.topN, k));
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "--payroll") {
+    int from = 0, to = 0;
+    if (argc < 4 || !parseDay(argv[2], from) || !parseDay(argv[3], to)) {
+      std::cerr << "usage: auto_repair --payroll <yyyy-mm-dd> <yyyy-mm-dd> [out.csv]" << std::endl;
+      return 2;
+    }
+    auto store = DataStorePersistence::load(dataPath, DataStorePersistence::LoadMode::HeadersOnly);
+    WorkOrderArchive archive(WorkOrderArchive::directoryFor(dataPath));
+    auto run = PayrollEngine::run(store, from, to, &archive);
+    const std::string out = argc > 4 ? argv[4] : PayrollEngine::fileNameFor(from, to);
+    if (!PayrollEngine::writeCsv(run, out)) {
+      std::cerr << "cannot write " << out << std::endl;
+      return 1;
+    }
+    std::cout << run.lines.size() << " employees, total " << run.total << ", written to " << out << std::endl;
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "--turnover-report") {
+    int from = 0, to = 0;
+    if (argc < 4 || !parseDay(argv[2], from) || !parseDay(argv[3], to)) {
+      std::cerr << "usage: auto_repair --turnover-report <yyyy-mm-dd> <yyyy-mm-dd>" << std::endl;
+      return 2;
+    }
+    auto store = DataStorePersistence::load(dataPath, DataStorePersistence::LoadMode::HeadersOnly);
+    auto all = ReportService::turnover(store.turnoverRollup, from, to);
+    std::cout << "technician,orders,turnover\n";
+    for (const auto& [tech, cell] : store.turnoverRollup.byTechnician(from, to)) {
+      std::cout << tech << ',' << cell.orders << ',' << cell.turnover << '\n';
+    }
+    std::cout << "total," << all.count << ',' << all.total << std::endl;
+    return 0;
   }
 
-  MainWindow w(store, QString::fromStdString(dataPath));
+  QApplication app(argc, argv);
+  // The window shows at once and loads the store on a worker thread
+  MainWindow w(QString::fromStdString(dataPath));
   w.show();
   return app.exec();
 }
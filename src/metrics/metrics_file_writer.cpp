@@ -0,0 +1,45 @@
+#include "metrics/metrics_file_writer.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+
+MetricsFileWriter::MetricsFileWriter(const MetricsRegistry& registry, std::string path, std::chrono::milliseconds interval)
+    : registry_(registry), path_(std::move(path)), interval_(interval) {
+  thread_ = std::thread([this] {
+    std::unique_lock<std::mutex> guard(mutex_);
+    while (!wake_.wait_for(guard, interval_, [this] { return stopping_; })) writeNow();
+  });
+}
+
+MetricsFileWriter::~MetricsFileWriter() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_one();
+  thread_.join();
+  writeNow();
+}
+
+bool MetricsFileWriter::writeNow() const {
+  const auto temp = path_ + ".tmp";
+  {
+    std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    registry_.writePrometheus(out);
+    if (!out.flush()) return false;
+  }
+  return std::rename(temp.c_str(), path_.c_str()) == 0;
+}
+
+void MetricsFileWriter::installFromEnvironment() {
+  const char* path = std::getenv(kPathVariable);
+  if (!path || !*path) return;
+  const char* interval = std::getenv(kIntervalVariable);
+  const long ms = interval ? std::strtol(interval, nullptr, 10) : 0;
+  // Constructed after the registry, so destroyed (with a final write) before it
+  auto& registry = MetricsRegistry::global();
+  static MetricsFileWriter writer(registry, path, std::chrono::milliseconds(ms > 0 ? ms : 10000));
+}
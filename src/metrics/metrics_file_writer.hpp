@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "metrics/metrics_registry.hpp"
+
+// Rewrites a Prometheus text file from a background thread every interval,
+// and once more when destroyed. Each write goes to a temporary file that is
+// renamed over the target, so a collector (e.g. node_exporter's textfile
+// collector) never reads a partial file.
+class MetricsFileWriter {
+public:
+  static constexpr const char* kPathVariable = "AUTO_REPAIR_METRICS";
+  static constexpr const char* kIntervalVariable = "AUTO_REPAIR_METRICS_INTERVAL_MS";
+
+  MetricsFileWriter(const MetricsRegistry& registry, std::string path, std::chrono::milliseconds interval);
+  ~MetricsFileWriter();
+  MetricsFileWriter(const MetricsFileWriter&) = delete;
+  MetricsFileWriter& operator=(const MetricsFileWriter&) = delete;
+
+  bool writeNow() const;
+
+  // If AUTO_REPAIR_METRICS names a file, writes the global registry there
+  // every AUTO_REPAIR_METRICS_INTERVAL_MS (default 10000) until exit. Call
+  // once from main.
+  static void installFromEnvironment();
+
+private:
+  const MetricsRegistry& registry_;
+  std::string path_;
+  std::chrono::milliseconds interval_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  bool stopping_{false};
+  std::thread thread_;
+};
@@ -0,0 +1,153 @@
+#include "metrics/metrics_registry.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace {
+void addTo(std::atomic<double>& target, double delta) {
+  auto current = target.load(std::memory_order_relaxed);
+  while (!target.compare_exchange_weak(current, current + delta, std::memory_order_relaxed)) {
+  }
+}
+
+std::string formatValue(double v) {
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%.15g", v);
+  return buf;
+}
+
+void writeEscaped(std::ostream& out, const std::string& text) {
+  for (char c : text) {
+    if (c == '\\') out << "\\\\";
+    else if (c == '"') out << "\\\"";
+    else if (c == '\n') out << "\\n";
+    else out << c;
+  }
+}
+
+// {a="x",b="y"}, with `extra` (e.g. le) appended; nothing when empty
+void writeLabels(std::ostream& out, const MetricLabels& labels, const std::pair<std::string, std::string>* extra = nullptr) {
+  if (labels.empty() && !extra) return;
+  out << '{';
+  bool first = true;
+  auto write = [&](const std::pair<std::string, std::string>& label) {
+    if (!first) out << ',';
+    first = false;
+    out << label.first << "=\"";
+    writeEscaped(out, label.second);
+    out << '"';
+  };
+  for (const auto& l : labels) write(l);
+  if (extra) write(*extra);
+  out << '}';
+}
+}
+
+void Gauge::add(double delta) { addTo(value_, delta); }
+
+Histogram::Histogram(std::vector<double> upperBounds) : bounds_(std::move(upperBounds)) {
+  std::sort(bounds_.begin(), bounds_.end());
+  counts_ = std::make_unique<std::atomic<std::uint64_t>[]>(bounds_.size() + 1);
+  for (std::size_t i = 0; i <= bounds_.size(); ++i) counts_[i].store(0, std::memory_order_relaxed);
+}
+
+void Histogram::observe(double v) {
+  const auto bucket = static_cast<std::size_t>(std::lower_bound(bounds_.begin(), bounds_.end(), v) - bounds_.begin());
+  counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  addTo(sum_, v);
+}
+
+MetricsRegistry& MetricsRegistry::global() {
+  static MetricsRegistry instance;
+  return instance;
+}
+
+MetricsRegistry::Series& MetricsRegistry::series(const std::string& name, const std::string& help, Type type,
+                                                 const MetricLabels& labels) {
+  auto it = families_.find(name);
+  if (it == families_.end()) it = families_.emplace(name, Family{type, help, {}}).first;
+  auto& family = it->second;
+  if (family.type != type) throw std::logic_error("metric " + name + " registered with another type");
+  for (auto& s : family.series) {
+    if (s.labels == labels) return s;
+  }
+  family.series.push_back(Series{labels, nullptr, nullptr, nullptr});
+  return family.series.back();
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const MetricLabels& labels) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& s = series(name, help, Type::Counter, labels);
+  if (!s.counter) s.counter = std::make_unique<Counter>();
+  return *s.counter;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const MetricLabels& labels) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& s = series(name, help, Type::Gauge, labels);
+  if (!s.gauge) s.gauge = std::make_unique<Gauge>();
+  return *s.gauge;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                      const std::vector<double>& upperBounds, const MetricLabels& labels) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& s = series(name, help, Type::Histogram, labels);
+  if (!s.histogram) s.histogram = std::make_unique<Histogram>(upperBounds);
+  return *s.histogram;
+}
+
+void MetricsRegistry::writePrometheus(std::ostream& out) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (const auto& [name, family] : families_) {
+    static const char* const kTypeNames[] = {"counter", "gauge", "histogram"};
+    out << "# HELP " << name << ' ' << family.help << '\n';
+    out << "# TYPE " << name << ' ' << kTypeNames[static_cast<int>(family.type)] << '\n';
+    for (const auto& s : family.series) {
+      if (s.counter) {
+        out << name;
+        writeLabels(out, s.labels);
+        out << ' ' << s.counter->value() << '\n';
+      } else if (s.gauge) {
+        out << name;
+        writeLabels(out, s.labels);
+        out << ' ' << formatValue(s.gauge->value()) << '\n';
+      } else if (s.histogram) {
+        const auto& h = *s.histogram;
+        // Read the buckets first so count never trails their sum
+        std::uint64_t cumulative = 0;
+        for (std::size_t i = 0; i <= h.upperBounds().size(); ++i) {
+          cumulative += h.bucketCount(i);
+          const std::pair<std::string, std::string> le{
+              "le", i < h.upperBounds().size() ? formatValue(h.upperBounds()[i]) : "+Inf"};
+          out << name << "_bucket";
+          writeLabels(out, s.labels, &le);
+          out << ' ' << cumulative << '\n';
+        }
+        out << name << "_sum";
+        writeLabels(out, s.labels);
+        out << ' ' << formatValue(h.sum()) << '\n';
+        out << name << "_count";
+        writeLabels(out, s.labels);
+        out << ' ' << cumulative << '\n';
+      }
+    }
+  }
+}
+
+const std::vector<double>& MetricsRegistry::durationBuckets() {
+  static const std::vector<double> buckets{0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01,
+                                           0.025,  0.05,    0.1,    0.25,  0.5,    1,     2.5,   5, 10};
+  return buckets;
+}
+
+const std::vector<double>& MetricsRegistry::sizeBuckets() {
+  static const std::vector<double> buckets = [] {
+    std::vector<double> b;
+    for (double v = 1024; v <= 256.0 * 1024 * 1024; v *= 4) b.push_back(v);
+    return b;
+  }();
+  return buckets;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Process-wide counters, gauges and histograms, written out in the
+// Prometheus text exposition format.
+//
+// Registering a series takes a mutex; updating one is a relaxed atomic
+// operation and never blocks. Hot paths look a series up once and keep the
+// reference, which stays valid for the life of the process:
+//
+//   static auto& detections = MetricsRegistry::global().counter("auto_repair_detections_total", "...");
+//   detections.inc();
+class Counter {
+public:
+  void inc(std::uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+  std::uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<std::uint64_t> value_{0};
+};
+
+class Gauge {
+public:
+  void set(double v) { value_.store(v, std::memory_order_relaxed); }
+  void add(double delta);
+  double value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<double> value_{0};
+};
+
+// Fixed upper bounds, counted per bucket; the exposition makes them
+// cumulative.
+class Histogram {
+public:
+  explicit Histogram(std::vector<double> upperBounds);
+
+  void observe(double v);
+  const std::vector<double>& upperBounds() const { return bounds_; }
+  // Observations in bucket i; i == upperBounds().size() is the +Inf bucket
+  std::uint64_t bucketCount(std::size_t i) const { return counts_[i].load(std::memory_order_relaxed); }
+  std::uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+  double sum() const { return sum_.load(std::memory_order_relaxed); }
+
+private:
+  std::vector<double> bounds_;
+  std::unique_ptr<std::atomic<std::uint64_t>[]> counts_;
+  std::atomic<std::uint64_t> count_{0};
+  std::atomic<double> sum_{0};
+};
+
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+class MetricsRegistry {
+public:
+  static MetricsRegistry& global();
+
+  // The same name and labels always return the same series. Registering a
+  // name again as a different type throws std::logic_error.
+  Counter& counter(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+  Gauge& gauge(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+  Histogram& histogram(const std::string& name, const std::string& help, const std::vector<double>& upperBounds,
+                       const MetricLabels& labels = {});
+
+  void writePrometheus(std::ostream& out) const;
+
+  // 100 µs to 10 s, for operation durations in seconds
+  static const std::vector<double>& durationBuckets();
+  // 1 KiB to 256 MiB, in powers of four
+  static const std::vector<double>& sizeBuckets();
+
+private:
+  enum class Type { Counter, Gauge, Histogram };
+  struct Series {
+    MetricLabels labels;
+    std::unique_ptr<Counter> counter;
+    std::unique_ptr<Gauge> gauge;
+    std::unique_ptr<Histogram> histogram;
+  };
+  struct Family {
+    Type type;
+    std::string help;
+    std::vector<Series> series;
+  };
+
+  mutable std::mutex mutex_;
+  std::map<std::string, Family> families_;
+
+  Series& series(const std::string& name, const std::string& help, Type type, const MetricLabels& labels);
+};
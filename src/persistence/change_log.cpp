@@ -0,0 +1,169 @@
+#include "persistence/change_log.hpp"
+#include "persistence/data_store_persistence.hpp"
+#include "persistence/work_order_json.hpp"
+#include "trace/tracer.hpp"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <chrono>
+
+namespace {
+std::int64_t wallMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+template <class T, class Key>
+void upsert(std::vector<T>& rows, std::unordered_map<std::string, std::size_t>& index, T value, Key key) {
+  auto it = index.find(key(value));
+  if (it != index.end()) {
+    rows[it->second] = std::move(value);
+    return;
+  }
+  index.emplace(key(value), rows.size());
+  rows.push_back(std::move(value));
+}
+}
+
+ChangeLogWriter::ChangeLogWriter(DataStore& store, std::string path) : store_(store), path_(std::move(path)) {}
+
+std::string ChangeLogWriter::pathFor(const std::string& dataPath) {
+  return QFileInfo(QString::fromStdString(dataPath)).dir().filePath("changelog.jsonl").toStdString();
+}
+
+bool ChangeLogWriter::restart() {
+  out_.close();
+  out_.open(path_, std::ios::out | std::ios::trunc);
+  if (!out_) return false;
+  const auto t = wallMicros();
+  QJsonObject marker{{"seq", static_cast<qint64>(store_.logSequence)}, {"t", static_cast<qint64>(t)},
+                     {"kind", "snapshot"}, {"run", QString::number(t)}};
+  out_ << QJsonDocument(marker).toJson(QJsonDocument::Compact).toStdString() << '\n';
+  out_.flush();
+  return true;
+}
+
+void ChangeLogWriter::onChange(const ChangeEvent& event) {
+  TRACE_SCOPE("changelog.append");
+  switch (event.entity) {
+    case Entity::Customer: append("customer", customerToJson(store_.customers[event.row])); break;
+    case Entity::Vehicle: append("vehicle", vehicleToJson(store_.vehicles[event.row])); break;
+    case Entity::Technician: append("technician", technicianToJson(store_.technicians[event.row])); break;
+    case Entity::WorkOrder: append("workOrder", workOrderToJson(store_.workOrders[event.row])); break;
+    case Entity::Part: append("part", stockedPartToJson(store_.parts[event.row])); break;
+  }
+}
+
+void ChangeLogWriter::append(const char* kind, const QJsonObject& data) {
+  if (!out_.is_open()) return;
+  const auto seq = ++store_.logSequence;
+  QJsonObject record{{"seq", static_cast<qint64>(seq)}, {"t", static_cast<qint64>(wallMicros())},
+                     {"kind", kind}, {"data", data}};
+  out_ << QJsonDocument(record).toJson(QJsonDocument::Compact).toStdString() << '\n';
+  if (flushEach_) out_.flush();
+}
+
+void ChangeLogWriter::flush() {
+  if (out_.is_open()) out_.flush();
+}
+
+ChangeLogFollower::ChangeLogFollower(std::string dataPath, std::string logPath)
+    : dataPath_(std::move(dataPath)), logPath_(std::move(logPath)) {}
+
+void ChangeLogFollower::bootstrap() {
+  store_ = DataStorePersistence::load(dataPath_, DataStorePersistence::LoadMode::HeadersOnly);
+  stats_.appliedSeq = store_.logSequence;
+  reindex();
+}
+
+void ChangeLogFollower::reindex() {
+  orderRow_.clear(); customerRow_.clear(); vehicleRow_.clear(); technicianRow_.clear(); partRow_.clear();
+  for (std::size_t i = 0; i < store_.workOrders.size(); ++i) orderRow_.emplace(store_.workOrders[i].id, i);
+  for (std::size_t i = 0; i < store_.customers.size(); ++i) customerRow_.emplace(store_.customers[i].id, i);
+  for (std::size_t i = 0; i < store_.vehicles.size(); ++i) vehicleRow_.emplace(store_.vehicles[i].vin, i);
+  for (std::size_t i = 0; i < store_.technicians.size(); ++i) technicianRow_.emplace(store_.technicians[i].id, i);
+  for (std::size_t i = 0; i < store_.parts.size(); ++i) partRow_.emplace(store_.parts[i].id, i);
+}
+
+std::size_t ChangeLogFollower::poll() {
+  TRACE_SCOPE("follower.poll");
+  std::ifstream in(logPath_, std::ios::binary);
+  if (!in) return 0;
+
+  // The first line names the primary run; a new run means a new snapshot
+  std::string line;
+  if (!std::getline(in, line) || in.eof()) return 0;
+  const auto marker = QJsonDocument::fromJson(QByteArray::fromStdString(line)).object();
+  const auto run = marker.value("run").toString().toStdString();
+  if (run != run_) {
+    if (!run_.empty()) {
+      bootstrap();
+      ++stats_.reloads;
+    }
+    run_ = run;
+    offset_ = line.size() + 1;
+  }
+
+  in.seekg(0, std::ios::end);
+  const auto size = static_cast<std::uint64_t>(in.tellg());
+  in.seekg(static_cast<std::streamoff>(offset_));
+  std::size_t applied = 0;
+  while (std::getline(in, line)) {
+    if (in.eof()) break; // partial last line; read it again next time
+    offset_ += line.size() + 1;
+    const auto record = QJsonDocument::fromJson(QByteArray::fromStdString(line)).object();
+    if (static_cast<std::uint64_t>(record.value("seq").toInteger()) <= store_.logSequence) continue;
+    apply(record);
+    ++applied;
+  }
+  pendingBytes_ = size - offset_;
+  return applied;
+}
+
+void ChangeLogFollower::apply(const QJsonObject& record) {
+  const auto kind = record.value("kind").toString();
+  const auto data = record.value("data").toObject();
+  if (kind == "workOrder") {
+    // Built in the store's arena, so replacing a row moves the items instead of copying them
+    applyOrder(workOrderFromJson(data, nullptr, store_.itemArena.resource()));
+  } else if (kind == "customer") {
+    upsert(store_.customers, customerRow_, customerFromJson(data), [](const Customer& c) { return c.id; });
+  } else if (kind == "vehicle") {
+    upsert(store_.vehicles, vehicleRow_, vehicleFromJson(data), [](const Vehicle& v) { return v.vin; });
+  } else if (kind == "technician") {
+    upsert(store_.technicians, technicianRow_, technicianFromJson(data), [](const Technician& t) { return t.id; });
+  } else if (kind == "part") {
+    upsert(store_.parts, partRow_, partFromJson(data), [](const Part& p) { return p.id; });
+  }
+  store_.logSequence = static_cast<std::uint64_t>(record.value("seq").toInteger());
+  stats_.appliedSeq = store_.logSequence;
+  ++stats_.records;
+  stats_.lastLagUs = wallMicros() - record.value("t").toInteger();
+  stats_.lagUs.record(stats_.lastLagUs);
+}
+
+void ChangeLogFollower::applyOrder(WorkOrder w) {
+  auto it = orderRow_.find(w.id);
+  const bool added = it == orderRow_.end();
+  const bool moved = added || store_.workOrders[it->second].status != w.status;
+  // Derived indexes advance once per transition, like the primary's
+  if (moved) {
+    store_.lifecycleStats.observe(w);
+    if (w.status == WOStatus::Paid) {
+      store_.serviceHistory.record(w);
+      store_.turnoverRollup.add(w);
+      store_.topN.record(w, w.partsConsumed);
+    }
+  }
+  std::size_t row = 0;
+  if (added) {
+    row = store_.workOrders.size();
+    orderRow_.emplace(w.id, row);
+    store_.workOrders.push_back(std::move(w));
+  } else {
+    row = it->second;
+    store_.workOrders[row] = std::move(w);
+  }
+  store_.orderColumns.sync(row, store_.workOrders[row]);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <QJsonObject>
+#include "domain/change_bus.hpp"
+#include "domain/data_store.hpp"
+#include "report/latency_histogram.hpp"
+
+// Change-log shipping to read-only followers through a file next to the
+// data store. The primary appends one JSON line per ChangeEvent with the
+// full new state of the entity:
+//   {"seq":N,"t":<wall µs>,"kind":"workOrder","data":{...}}
+// Each primary run starts the file over with a "snapshot" line naming the
+// run; followers seeing a new run reload the saved store and replay from
+// there. Records at or below the store's logSequence are already in it.
+class ChangeLogWriter : public ChangeObserver {
+public:
+  ChangeLogWriter(DataStore& store, std::string path);
+
+  // Truncates the log and writes the run's snapshot line. Call once the
+  // saved file matches the store.
+  bool restart();
+  void onChange(const ChangeEvent& event) override;
+  // Records are flushed one by one so followers see each on their next
+  // poll. Bulk writers turn that off and flush() when a batch is done.
+  void setFlushEachRecord(bool flushEach) { flushEach_ = flushEach; }
+  void flush();
+
+  static std::string pathFor(const std::string& dataPath);
+
+private:
+  DataStore& store_;
+  std::string path_;
+  std::ofstream out_;
+  bool flushEach_{true};
+
+  void append(const char* kind, const QJsonObject& data);
+};
+
+struct ReplicationStats {
+  std::uint64_t appliedSeq{0};
+  std::uint64_t records{0};   // applied since start
+  std::uint64_t reloads{0};   // snapshot reloads after a primary restart
+  std::int64_t lastLagUs{0};
+  LatencyHistogram lagUs;     // primary write to follower apply, in µs
+};
+
+// Keeps a DataStore in step with a primary by tailing its change log.
+// Work orders, customers, vehicles, technicians and parts are upserted by
+// id, and the report indexes (columns, rollups, top-N, stage latencies,
+// service history) are updated as orders change status, as the primary's
+// WorkshopService does.
+class ChangeLogFollower {
+public:
+  ChangeLogFollower(std::string dataPath, std::string logPath);
+
+  // Loads the saved store; poll() then applies what came after it.
+  void bootstrap();
+  // Applies every complete record appended since the last call.
+  std::size_t poll();
+
+  const DataStore& store() const { return store_; }
+  const ReplicationStats& stats() const { return stats_; }
+  // Bytes of the log not applied yet, as of the last poll
+  std::uint64_t pendingBytes() const { return pendingBytes_; }
+
+private:
+  std::string dataPath_;
+  std::string logPath_;
+  DataStore store_;
+  ReplicationStats stats_;
+  std::string run_;          // run id of the log being followed
+  std::uint64_t offset_{0};  // bytes of the log consumed
+  std::uint64_t pendingBytes_{0};
+  std::unordered_map<std::string, std::size_t> orderRow_, customerRow_, vehicleRow_, technicianRow_, partRow_;
+
+  void reindex();
+  void apply(const QJsonObject& record);
+  void applyOrder(WorkOrder w);
+};
@@ -1,15 +1,23 @@
 #include "persistence/data_store_persistence.hpp"
+#include "persistence/work_order_archive.hpp"
+#include "persistence/work_order_json.hpp"
+#include "metrics/metrics_registry.hpp"
+#include "trace/tracer.hpp"
 
+#include <QDateTime>
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QSaveFile>
 #include <algorithm>
+#include <cctype>
+#include <chrono>
 #include <memory>
+#include <string>
 
-namespace {
-QString statusToString(WOStatus st) {
+const char* statusName(WOStatus st) {
   switch (st) {
     case WOStatus::Draft: return "Draft";
     case WOStatus::Assigned: return "Assigned";
@@ -21,6 +29,10 @@ QString statusToString(WOStatus st) {
   return "Draft";
 }
 
+QString statusToString(WOStatus st) {
+  return statusName(st);
+}
+
 WOStatus statusFromString(const QString& str) {
   if (str == "Assigned") return WOStatus::Assigned;
   if (str == "InProgress") return WOStatus::InProgress;
@@ -47,7 +59,7 @@ Customer customerFromJson(const QJsonObject& o) {
 QJsonObject vehicleToJson(const Vehicle& v) {
   return QJsonObject{{"vin", QString::fromStdString(v.vin)}, {"plate", QString::fromStdString(v.plate)},
                      {"brand", QString::fromStdString(v.brand)}, {"model", QString::fromStdString(v.model)},
-                     {"year", v.year}, {"ownerId", QString::fromStdString(v.ownerId)}};
+                     {"year", v.year}, {"ownerId", QString::fromStdString(v.ownerId)}, {"mileage", v.mileage}};
 }
 
 Vehicle vehicleFromJson(const QJsonObject& o) {
@@ -58,48 +70,41 @@ Vehicle vehicleFromJson(const QJsonObject& o) {
   v.model = o.value("model").toString().toStdString();
   v.year = o.value("year").toInt();
   v.ownerId = o.value("ownerId").toString().toStdString();
+  v.mileage = o.value("mileage").toInt();
   return v;
 }
 
 QJsonObject technicianToJson(const Technician& t) {
   QJsonArray assigned;
-  for (const auto& id : t.assignedWorkOrders) assigned.push_back(QString::fromStdString(id));
+  for (auto wo : t.assignedWorkOrders) assigned.push_back(QString::fromStdString(IdTable::workOrders().name(wo)));
   return QJsonObject{{"id", QString::fromStdString(t.id)}, {"name", QString::fromStdString(t.name)},
                      {"hourlyRate", t.hourlyRate}, {"hoursWorked", t.hoursWorked},
                      {"assigned", assigned}};
 }
 
-QJsonObject advisorToJson(const ServiceAdvisor& a) {
-  return QJsonObject{{"id", QString::fromStdString(a.id)}, {"name", QString::fromStdString(a.name)},
-                     {"baseSalary", a.baseSalary}, {"commission", a.commission}};
-}
-
 Technician technicianFromJson(const QJsonObject& o) {
   Technician t;
   t.id = o.value("id").toString().toStdString();
   t.name = o.value("name").toString().toStdString();
   t.hourlyRate = o.value("hourlyRate").toDouble();
-  t.hoursWorked = o.value("hoursWorked").toInt();
+  t.hoursWorked = o.value("hoursWorked").toDouble();
   auto assigned = o.value("assigned").toArray();
-  for (const auto& v : assigned) t.assignedWorkOrders.push_back(v.toString().toStdString());
+  for (const auto& v : assigned) t.assignedWorkOrders.push_back(IdTable::workOrders().intern(v.toString().toStdString()));
   return t;
 }
 
-ServiceAdvisor advisorFromJson(const QJsonObject& o) {
-  ServiceAdvisor a;
-  a.id = o.value("id").toString().toStdString();
-  a.name = o.value("name").toString().toStdString();
-  a.baseSalary = o.value("baseSalary").toDouble();
-  a.commission = o.value("commission").toDouble();
-  return a;
-}
-
 QJsonObject partToJson(const Part& p) {
   return QJsonObject{{"id", QString::fromStdString(p.id)}, {"name", QString::fromStdString(p.name)},
                      {"unitPrice", p.unitPrice}, {"stock", p.stock}, {"reorderPoint", p.reorderPoint},
                      {"capacity", p.capacity}};
 }
 
+QJsonObject stockedPartToJson(const Part& p) {
+  auto o = partToJson(p);
+  o.insert("version", static_cast<qint64>(p.version));
+  return o;
+}
+
 Part partFromJson(const QJsonObject& o) {
   Part p;
   p.id = o.value("id").toString().toStdString();
@@ -108,9 +113,40 @@ Part partFromJson(const QJsonObject& o) {
   p.stock = o.value("stock").toInt();
   p.reorderPoint = o.value("reorderPoint").toInt();
   p.capacity = o.value("capacity").toInt();
+  p.version = static_cast<std::uint64_t>(o.value("version").toInteger());
+  p.handle = IdTable::parts().intern(p.id);
   return p;
 }
 
+namespace {
+QJsonObject advisorToJson(const ServiceAdvisor& a) {
+  return QJsonObject{{"id", QString::fromStdString(a.id)}, {"name", QString::fromStdString(a.name)},
+                     {"baseSalary", a.baseSalary}, {"commission", a.commission}};
+}
+
+ServiceAdvisor advisorFromJson(const QJsonObject& o) {
+  ServiceAdvisor a;
+  a.id = o.value("id").toString().toStdString();
+  a.name = o.value("name").toString().toStdString();
+  a.baseSalary = o.value("baseSalary").toDouble();
+  a.commission = o.value("commission").toDouble();
+  return a;
+}
+
+QJsonObject managerToJson(const Manager& m) {
+  return QJsonObject{{"id", QString::fromStdString(m.id)}, {"name", QString::fromStdString(m.name)},
+                     {"baseSalary", m.baseSalary}, {"bonus", m.bonus}};
+}
+
+Manager managerFromJson(const QJsonObject& o) {
+  Manager m;
+  m.id = o.value("id").toString().toStdString();
+  m.name = o.value("name").toString().toStdString();
+  m.baseSalary = o.value("baseSalary").toDouble();
+  m.bonus = o.value("bonus").toDouble();
+  return m;
+}
+
 QJsonObject serviceToJson(const ServiceItem& s) {
   return QJsonObject{{"id", QString::fromStdString(s.id)}, {"name", QString::fromStdString(s.name)},
                      {"laborHours", s.laborHours}, {"basePrice", s.basePrice}};
@@ -153,8 +189,8 @@ QJsonObject woItemToJson(const WOItem& item) {
   return obj;
 }
 
-WOItem woItemFromJson(const QJsonObject& o) {
-  WOItem it;
+WOItem woItemFromJson(const QJsonObject& o, const WOItem::allocator_type& alloc) {
+  WOItem it(alloc);
   it.item = serviceFromJson(o.value("service").toObject());
   it.laborHoursOverride = o.value("laborOverride").toDouble(-1);
   it.autoDetected = o.value("autoDetected").toBool(false);
@@ -166,6 +202,237 @@ WOItem woItemFromJson(const QJsonObject& o) {
   return it;
 }
 
+QJsonObject lifecycleToJson(const Lifecycle& lc) {
+  QJsonObject obj;
+  auto put = [&](const char* name, const StageStamp& st) {
+    if (!st.recorded()) return;
+    obj.insert(name, QJsonObject{{"steadyUs", static_cast<qint64>(st.steadyUs)},
+                                 {"wallMs", static_cast<qint64>(st.wallMs)}});
+  };
+  put("created", lc.created);
+  put("assigned", lc.assigned);
+  put("started", lc.started);
+  put("completed", lc.completed);
+  put("settled", lc.settled);
+  return obj;
+}
+
+Lifecycle lifecycleFromJson(const QJsonObject& o) {
+  auto get = [&](const char* name) {
+    auto st = o.value(name).toObject();
+    return StageStamp{st.value("steadyUs").toInteger(), st.value("wallMs").toInteger()};
+  };
+  Lifecycle lc;
+  lc.created = get("created");
+  lc.assigned = get("assigned");
+  lc.started = get("started");
+  lc.completed = get("completed");
+  lc.settled = get("settled");
+  return lc;
+}
+
+QJsonArray lifecycleStatsToJson(const LifecycleStats& stats) {
+  QJsonArray arr;
+  stats.forEach([&](Stage stage, const char* group, const std::string& key, const LatencyHistogram& h) {
+    if (h.count() == 0) return;
+    QJsonArray buckets;
+    for (const auto& [bucket, count] : h.buckets()) {
+      buckets.push_back(QJsonArray{static_cast<qint64>(bucket), static_cast<qint64>(count)});
+    }
+    arr.push_back(QJsonObject{{"stage", stageName(stage)}, {"group", group},
+                              {"key", QString::fromStdString(key)}, {"buckets", buckets}});
+  });
+  return arr;
+}
+
+void lifecycleStatsFromJson(const QJsonArray& arr, LifecycleStats& stats) {
+  for (const auto& v : arr) {
+    auto o = v.toObject();
+    auto name = o.value("stage").toString();
+    auto stage = std::find_if(kStages.begin(), kStages.end(), [&](Stage s){ return name == stageName(s); });
+    if (stage == kStages.end()) continue;
+    auto group = o.value("group").toString().toStdString();
+    auto key = o.value("key").toString().toStdString();
+    for (const auto& b : o.value("buckets").toArray()) {
+      auto pair = b.toArray();
+      stats.restoreBucket(*stage, group, key, static_cast<std::size_t>(pair.at(0).toInteger()),
+                          static_cast<std::uint64_t>(pair.at(1).toInteger()));
+    }
+  }
+}
+
+QJsonArray rollupToJson(const TurnoverRollup& r) {
+  QJsonArray arr;
+  for (const auto& [key, cell] : r.days()) {
+    const auto& [day, tech, service] = key;
+    arr.push_back(QJsonObject{{"day", day}, {"tech", QString::fromStdString(tech)},
+                              {"service", QString::fromStdString(service)},
+                              {"turnover", cell.turnover}, {"orders", cell.orders}});
+  }
+  return arr;
+}
+
+void rollupFromJson(const QJsonArray& arr, TurnoverRollup& r) {
+  for (const auto& v : arr) {
+    auto o = v.toObject();
+    r.addDayCell(o.value("day").toInt(), o.value("tech").toString().toStdString(),
+                 o.value("service").toString().toStdString(),
+                 RollupCell{o.value("turnover").toDouble(), o.value("orders").toInt()});
+  }
+}
+
+QJsonObject counterToJson(const TopCounter& c) {
+  QJsonObject obj;
+  for (const auto& [key, value] : c.totals()) obj.insert(QString::fromStdString(key), value);
+  return obj;
+}
+
+void counterFromJson(const QJsonObject& o, TopCounter& c) {
+  for (auto it = o.begin(); it != o.end(); ++it) c.add(it.key().toStdString(), it.value().toDouble());
+}
+
+QJsonObject topNToJson(const TopNTracker& t) {
+  return QJsonObject{{"parts", counterToJson(t.partsByQuantity)},
+                     {"customers", counterToJson(t.customersByRevenue)},
+                     {"technicians", counterToJson(t.techniciansByOrders)}};
+}
+
+void topNFromJson(const QJsonObject& o, TopNTracker& t) {
+  counterFromJson(o.value("parts").toObject(), t.partsByQuantity);
+  counterFromJson(o.value("customers").toObject(), t.customersByRevenue);
+  counterFromJson(o.value("technicians").toObject(), t.techniciansByOrders);
+}
+
+QJsonArray serviceHistoryToJson(const ServiceHistory& h) {
+  QJsonArray arr;
+  h.forEach([&](const std::string& vin, const ServiceRecord& r) {
+    arr.push_back(QJsonObject{{"vin", QString::fromStdString(vin)}, {"serviceId", QString::fromStdString(r.serviceId)},
+                              {"workOrderId", QString::fromStdString(r.workOrderId)},
+                              {"completedAt", static_cast<qint64>(r.completedAt)}, {"mileage", r.mileage}});
+  });
+  return arr;
+}
+
+void serviceHistoryFromJson(const QJsonArray& arr, ServiceHistory& h) {
+  for (const auto& v : arr) {
+    auto o = v.toObject();
+    ServiceRecord r;
+    r.serviceId = o.value("serviceId").toString().toStdString();
+    r.workOrderId = o.value("workOrderId").toString().toStdString();
+    r.completedAt = o.value("completedAt").toInteger();
+    r.mileage = o.value("mileage").toInt();
+    h.add(o.value("vin").toString().toStdString(), r);
+  }
+}
+
+QJsonArray pendingItemsJson(const PendingItems& p) {
+  auto raw = QByteArray::fromRawData(p.source->data() + p.offset, static_cast<qsizetype>(p.length));
+  return QJsonDocument::fromJson(raw).array();
+}
+
+// Minimal structural JSON scanner for header-only loads. It only finds value
+// boundaries so item arrays can be cut out; QJsonDocument does the parsing.
+class JsonScanner {
+public:
+  explicit JsonScanner(const std::string& s) : s_(s), n_(s.size()) {}
+
+  std::size_t skipWs(std::size_t i) const {
+    while (i < n_ && std::isspace(static_cast<unsigned char>(s_[i]))) ++i;
+    return i;
+  }
+
+  bool keyIs(std::size_t keyStart, std::size_t keyEnd, const char* name) const {
+    auto len = std::char_traits<char>::length(name);
+    return keyEnd - keyStart == len + 2 && s_.compare(keyStart + 1, len, name) == 0;
+  }
+
+  std::size_t skipValue(std::size_t i) const {
+    if (i >= n_) return n_;
+    if (s_[i] == '"') return skipString(i);
+    if (s_[i] == '{' || s_[i] == '[') {
+      int depth = 0;
+      for (; i < n_; ++i) {
+        char c = s_[i];
+        if (c == '"') i = skipString(i) - 1;
+        else if (c == '{' || c == '[') ++depth;
+        else if ((c == '}' || c == ']') && --depth == 0) return i + 1;
+      }
+      return n_;
+    }
+    while (i < n_ && s_[i] != ',' && s_[i] != '}' && s_[i] != ']' &&
+           !std::isspace(static_cast<unsigned char>(s_[i]))) ++i;
+    return i;
+  }
+
+  // fn(keyStart, keyEnd, valueStart, valueEnd) for each member of the object at i
+  template <typename Fn>
+  void forEachMember(std::size_t i, Fn&& fn) const {
+    i = skipWs(i + 1);
+    while (i < n_ && s_[i] == '"') {
+      std::size_t keyEnd = skipString(i);
+      std::size_t valueStart = skipWs(skipWs(keyEnd) + 1);
+      std::size_t valueEnd = skipValue(valueStart);
+      fn(i, keyEnd, valueStart, valueEnd);
+      i = skipWs(valueEnd);
+      if (i < n_ && s_[i] == ',') i = skipWs(i + 1);
+    }
+  }
+
+  // fn(valueStart, valueEnd) for each element of the array at i
+  template <typename Fn>
+  void forEachElement(std::size_t i, Fn&& fn) const {
+    i = skipWs(i + 1);
+    while (i < n_ && s_[i] != ']') {
+      std::size_t end = skipValue(i);
+      fn(i, end);
+      i = skipWs(end);
+      if (i < n_ && s_[i] == ',') i = skipWs(i + 1);
+      else break;
+    }
+  }
+
+private:
+  const std::string& s_;
+  std::size_t n_;
+
+  std::size_t skipString(std::size_t i) const {
+    for (++i; i < n_; ++i) {
+      if (s_[i] == '\\') ++i;
+      else if (s_[i] == '"') return i + 1;
+    }
+    return n_;
+  }
+};
+
+// Copies `json` with every workOrders[i].items member replaced by
+// "itemsRef":[offset,length], and appends the item arrays themselves to
+// `items`, which the refs point into. The rest of the file is not kept.
+std::string stripOrderItems(const std::string& json, std::string& items) {
+  JsonScanner scan(json);
+  std::size_t root = scan.skipWs(0);
+  if (root >= json.size() || json[root] != '{') return json;
+
+  std::string out;
+  out.reserve(json.size() / 2);
+  std::size_t copied = 0;
+  scan.forEachMember(root, [&](std::size_t ks, std::size_t ke, std::size_t vs, std::size_t) {
+    if (!scan.keyIs(ks, ke, "workOrders") || json[vs] != '[') return;
+    scan.forEachElement(vs, [&](std::size_t es, std::size_t) {
+      if (json[es] != '{') return;
+      scan.forEachMember(es, [&](std::size_t iks, std::size_t ike, std::size_t ivs, std::size_t ive) {
+        if (!scan.keyIs(iks, ike, "items")) return;
+        out.append(json, copied, iks - copied);
+        out += "\"itemsRef\":[" + std::to_string(items.size()) + "," + std::to_string(ive - ivs) + "]";
+        items.append(json, ivs, ive - ivs);
+        copied = ive;
+      });
+    });
+  });
+  out.append(json, copied, std::string::npos);
+  return out;
+}
+}
+
 QJsonObject workOrderToJson(const WorkOrder& w) {
   QJsonObject obj;
   obj.insert("id", QString::fromStdString(w.id));
@@ -174,55 +441,178 @@ QJsonObject workOrderToJson(const WorkOrder& w) {
   obj.insert("tech", technicianToJson(w.tech));
   obj.insert("customer", customerToJson(w.customer));
   obj.insert("status", statusToString(w.status));
+  if (w.closedAt > 0) obj.insert("closedAt", static_cast<qint64>(w.closedAt));
+  obj.insert("version", static_cast<qint64>(w.version));
+  // Always present on Paid orders, so readers can tell false from unrecorded
+  if (w.partsConsumed || w.status == WOStatus::Paid) obj.insert("partsConsumed", w.partsConsumed);
+  obj.insert("lifecycle", lifecycleToJson(w.lifecycle));
   obj.insert("detectionNote", QString::fromStdString(w.detectionNote));
   obj.insert("pricing", pricingToString(*w.pricing));
+  obj.insert("total", w.previewTotal());
+  if (w.pendingItems) {
+    obj.insert("items", pendingItemsJson(*w.pendingItems));
+    return obj;
+  }
   QJsonArray items;
   for (const auto& it : w.items) items.push_back(woItemToJson(it));
   obj.insert("items", items);
   return obj;
 }
 
-WorkOrder workOrderFromJson(const QJsonObject& o) {
-  WorkOrder w;
+WorkOrder workOrderFromJson(const QJsonObject& o, const std::shared_ptr<const std::string>& source,
+                            std::pmr::memory_resource* itemResource) {
+  WorkOrder w(itemResource);
   w.id = o.value("id").toString().toStdString();
   w.vehicle = vehicleFromJson(o.value("vehicle").toObject());
   w.advisor = advisorFromJson(o.value("advisor").toObject());
   w.tech = technicianFromJson(o.value("tech").toObject());
   w.customer = customerFromJson(o.value("customer").toObject());
   w.status = statusFromString(o.value("status").toString());
+  w.closedAt = o.value("closedAt").toInteger();
+  w.version = static_cast<std::uint64_t>(o.value("version").toInteger());
+  w.partsConsumed = o.value("partsConsumed").toBool();
+  w.lifecycle = lifecycleFromJson(o.value("lifecycle").toObject());
   w.detectionNote = o.value("detectionNote").toString().toStdString();
   w.pricing = pricingFromString(o.value("pricing").toString());
+  auto ref = o.value("itemsRef").toArray();
+  if (source && ref.size() == 2) {
+    w.pendingItems = PendingItems{source, static_cast<std::size_t>(ref.at(0).toInteger()),
+                                  static_cast<std::size_t>(ref.at(1).toInteger())};
+    w.cachedTotal = o.value("total").toDouble();
+    // Files written before totals were saved need the items to price the order
+    if (!o.contains("total")) DataStorePersistence::hydrate(w);
+    return w;
+  }
   auto itemsArr = o.value("items").toArray();
-  for (const auto& v : itemsArr) w.items.push_back(woItemFromJson(v.toObject()));
+  w.items.reserve(static_cast<std::size_t>(itemsArr.size()));
+  for (const auto& v : itemsArr) w.items.push_back(woItemFromJson(v.toObject(), w.items.get_allocator()));
   return w;
 }
+
+void DataStorePersistence::hydrate(WorkOrder& order) {
+  if (!order.pendingItems) return;
+  TRACE_SCOPE("persistence.hydrate");
+  // Decoded straight into the order's resource, its store's arena after a load
+  order.items = decodeItems(*order.pendingItems, order.items.get_allocator().resource());
+  order.pendingItems.reset();
+}
+
+WOItemList DataStorePersistence::decodeItems(const PendingItems& pending, std::pmr::memory_resource* resource) {
+  WOItemList items(resource);
+  const auto json = pendingItemsJson(pending);
+  items.reserve(static_cast<std::size_t>(json.size()));
+  for (const auto& v : json) items.push_back(woItemFromJson(v.toObject(), items.get_allocator()));
+  return items;
 }
 
-DataStore DataStorePersistence::load(const std::string& path) {
+DataStore DataStorePersistence::load(const std::string& path, LoadMode mode, const Progress& progress) {
+  TRACE_SCOPE("persistence.load");
+  auto report = [&](int percent) { if (progress) progress(percent); };
   QFile file(QString::fromStdString(path));
   DataStore store;
   if (!file.exists()) return store;
   if (!file.open(QIODevice::ReadOnly)) return store;
-  auto doc = QJsonDocument::fromJson(file.readAll());
+  auto bytes = file.readAll();
+  report(15);
+  std::shared_ptr<const std::string> source;
+  QJsonDocument doc;
+  if (mode == LoadMode::HeadersOnly) {
+    // Orders keep only the item arrays; the buffer goes once all are hydrated
+    std::string items;
+    bytes = QByteArray::fromStdString(
+        stripOrderItems(std::string(bytes.constData(), static_cast<std::size_t>(bytes.size())), items));
+    items.shrink_to_fit();
+    source = std::make_shared<const std::string>(std::move(items));
+  }
+  {
+    TRACE_SCOPE("persistence.load.parse");
+    doc = QJsonDocument::fromJson(bytes);
+  }
   if (!doc.isObject()) return store;
   auto root = doc.object();
+  report(40);
 
   for (const auto& v : root.value("customers").toArray()) store.customers.push_back(customerFromJson(v.toObject()));
   for (const auto& v : root.value("vehicles").toArray()) store.vehicles.push_back(vehicleFromJson(v.toObject()));
   for (const auto& v : root.value("technicians").toArray()) store.technicians.push_back(technicianFromJson(v.toObject()));
+  for (const auto& v : root.value("advisors").toArray()) store.advisors.push_back(advisorFromJson(v.toObject()));
+  for (const auto& v : root.value("managers").toArray()) store.managers.push_back(managerFromJson(v.toObject()));
   for (const auto& v : root.value("parts").toArray()) store.parts.push_back(partFromJson(v.toObject()));
-  for (const auto& v : root.value("workOrders").toArray()) store.workOrders.push_back(workOrderFromJson(v.toObject()));
+  // Every order's items come from one arena, released with the store
+  store.itemArena = ItemArena::pooled();
+  const auto orders = root.value("workOrders").toArray();
+  store.workOrders.reserve(static_cast<std::size_t>(orders.size()));
+  for (const auto& v : orders) {
+    store.workOrders.push_back(workOrderFromJson(v.toObject(), source, store.itemArena.resource()));
+  }
+  store.archiveAfterDays = root.value("archiveAfterDays").toInt(store.archiveAfterDays);
+  store.logSequence = static_cast<std::uint64_t>(root.value("logSequence").toInteger());
+  report(70);
+
+  // Orders closed before closedAt was recorded age from the file's last write
+  const auto legacyClosedAt = QFileInfo(file).lastModified().toMSecsSinceEpoch();
+  for (auto& w : store.workOrders) {
+    if (isClosed(w.status) && w.closedAt == 0) w.closedAt = legacyClosedAt;
+  }
+
+  lifecycleStatsFromJson(root.value("lifecycleStats").toArray(), store.lifecycleStats);
+
+  const bool hasHistory = root.contains("serviceHistory");
+  // Rollups saved as "turnoverRollup" counted an order once per item rather
+  // than once per service, so they are rebuilt rather than restored.
+  const bool hasRollup = root.contains("turnoverCells");
+  const bool hasTopN = root.contains("topN");
+  if (hasHistory) serviceHistoryFromJson(root.value("serviceHistory").toArray(), store.serviceHistory);
+  if (hasRollup) rollupFromJson(root.value("turnoverCells").toArray(), store.turnoverRollup);
+  if (hasTopN) topNFromJson(root.value("topN").toObject(), store.topN);
+  if (!hasHistory || !hasRollup || !hasTopN) {
+    // One-time backfill for files written before these indexes were persisted,
+    // over the live orders and those already swept into the archive.
+    // Files older than the partsConsumed flag carry it on no order; their Paid
+    // orders are assumed to have taken their parts, as settling did then.
+    // The archive was written by the same or an older version, so it follows
+    // the main file.
+    bool recordsConsumption = false;
+    for (const auto& v : orders) recordsConsumption = recordsConsumption || v.toObject().contains("partsConsumed");
+    auto backfill = [&](const WorkOrder& full) {
+      if (full.status != WOStatus::Paid) return;
+      if (!hasHistory) store.serviceHistory.record(full);
+      if (!hasRollup) store.turnoverRollup.add(full);
+      if (!hasTopN) store.topN.record(full, recordsConsumption ? full.partsConsumed : true);
+    };
+    for (const auto& w : store.workOrders) {
+      if (w.status != WOStatus::Paid) continue;
+      WorkOrder full = w;
+      hydrate(full);
+      backfill(full);
+    }
+    WorkOrderArchive(WorkOrderArchive::directoryFor(path)).forEach(backfill);
+  }
+
+  report(90);
+  store.orderColumns.rebuild(store.workOrders);
 
   // Refresh assigned work orders from orders to ensure consistency
-  for (auto& t : store.technicians) t.assignedWorkOrders.clear();
+  std::vector<std::size_t> techRow; // technician handle -> row
+  for (std::size_t i = 0; i < store.technicians.size(); ++i) {
+    auto& t = store.technicians[i];
+    t.assignedWorkOrders.clear();
+    const auto handle = IdTable::technicians().intern(t.id);
+    if (handle >= techRow.size()) techRow.resize(handle + 1, store.technicians.size());
+    techRow[handle] = i;
+  }
   for (const auto& w : store.workOrders) {
-    auto it = std::find_if(store.technicians.begin(), store.technicians.end(), [&](const Technician& t){ return t.id == w.tech.id; });
-    if (it != store.technicians.end()) it->assignedWorkOrders.push_back(w.id);
+    const auto handle = IdTable::technicians().find(w.tech.id);
+    if (handle < techRow.size() && techRow[handle] < store.technicians.size()) {
+      store.technicians[techRow[handle]].assignedWorkOrders.push_back(IdTable::workOrders().intern(w.id));
+    }
   }
   return store;
 }
 
 void DataStorePersistence::save(const DataStore& store, const std::string& path) {
+  TRACE_SCOPE("persistence.save");
+  const auto started = std::chrono::steady_clock::now();
   QJsonObject root;
   QJsonArray customers;
   for (const auto& c : store.customers) customers.push_back(customerToJson(c));
@@ -236,18 +626,44 @@ void DataStorePersistence::save(const DataStore& store, const std::string& path)
   for (const auto& t : store.technicians) technicians.push_back(technicianToJson(t));
   root.insert("technicians", technicians);
 
+  QJsonArray advisors;
+  for (const auto& a : store.advisors) advisors.push_back(advisorToJson(a));
+  root.insert("advisors", advisors);
+
+  QJsonArray managers;
+  for (const auto& m : store.managers) managers.push_back(managerToJson(m));
+  root.insert("managers", managers);
+
   QJsonArray parts;
-  for (const auto& p : store.parts) parts.push_back(partToJson(p));
+  for (const auto& p : store.parts) parts.push_back(stockedPartToJson(p));
   root.insert("parts", parts);
 
   QJsonArray workOrders;
   for (const auto& w : store.workOrders) workOrders.push_back(workOrderToJson(w));
   root.insert("workOrders", workOrders);
+  root.insert("archiveAfterDays", store.archiveAfterDays);
+  root.insert("logSequence", static_cast<qint64>(store.logSequence));
+  root.insert("serviceHistory", serviceHistoryToJson(store.serviceHistory));
+  root.insert("lifecycleStats", lifecycleStatsToJson(store.lifecycleStats));
+  root.insert("turnoverCells", rollupToJson(store.turnoverRollup));
+  root.insert("topN", topNToJson(store.topN));
 
   QJsonDocument doc(root);
   QSaveFile file(QString::fromStdString(path));
   if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return;
-  file.write(doc.toJson());
-  file.commit();
+  TRACE_SCOPE("persistence.save.write");
+  const auto bytes = doc.toJson();
+  file.write(bytes);
+  if (!file.commit()) return;
+
+  auto& metrics = MetricsRegistry::global();
+  static auto& duration = metrics.histogram("auto_repair_persist_duration_seconds", "Time to encode and write the store",
+                                            MetricsRegistry::durationBuckets());
+  static auto& size = metrics.histogram("auto_repair_persist_bytes", "Size of each saved store",
+                                        MetricsRegistry::sizeBuckets());
+  static auto& written = metrics.counter("auto_repair_persist_bytes_total", "Bytes written by saves");
+  duration.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count());
+  size.observe(static_cast<double>(bytes.size()));
+  written.inc(static_cast<std::uint64_t>(bytes.size()));
 }
 
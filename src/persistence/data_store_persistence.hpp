@@ -1,11 +1,25 @@
 #pragma once
 
+#include <functional>
 #include <string>
 #include "domain/data_store.hpp"
 
 class DataStorePersistence {
 public:
-  static DataStore load(const std::string& path);
+  enum class LoadMode {
+    Full,        // decode every work order item
+    HeadersOnly  // leave items as PendingItems until hydrate()
+  };
+
+  // Receives a rough completion percentage as loading advances.
+  using Progress = std::function<void(int percent)>;
+
+  static DataStore load(const std::string& path, LoadMode mode = LoadMode::Full, const Progress& progress = {});
   static void save(const DataStore& store, const std::string& path);
+  // Decodes pending items of a header-only order; no-op when already hydrated.
+  static void hydrate(WorkOrder& order);
+  // Decodes pending items into a list of their own, leaving the order as is.
+  static WOItemList decodeItems(const PendingItems& pending,
+                                std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 };
 
@@ -0,0 +1,96 @@
+#include "persistence/store_bootstrap.hpp"
+#include "persistence/file_repository.hpp"
+#include "domain/maintenance_detector.hpp"
+#include "trace/tracer.hpp"
+
+#include <QDateTime>
+#include <algorithm>
+
+DataStore StoreBootstrap::loadOrSeed(const std::string& dataPath, const DataStorePersistence::Progress& progress) {
+  TRACE_SCOPE("bootstrap.loadOrSeed");
+  DataStore store = DataStorePersistence::load(dataPath, DataStorePersistence::LoadMode::HeadersOnly, progress);
+  if (store.customers.empty() && store.vehicles.empty() && store.workOrders.empty()) {
+    seedSampleData(store);
+    DataStorePersistence::save(store, dataPath);
+  } else {
+    seedParts(store);
+  }
+  return store;
+}
+
+void StoreBootstrap::seedParts(DataStore& store) {
+  if (!store.parts.empty()) return;
+  PartCsvRepository partRepo("data/parts.csv");
+  store.parts = partRepo.findAll();
+}
+
+int StoreBootstrap::archiveAged(DataStore& store, WorkOrderArchive& archive, const std::string& dataPath) {
+  const int moved = archive.sweep(store.workOrders, store.archiveAfterDays, QDateTime::currentMSecsSinceEpoch());
+  if (moved == 0) return 0;
+  store.orderColumns.rebuild(store.workOrders);
+  DataStorePersistence::save(store, dataPath);
+  return moved;
+}
+
+void StoreBootstrap::seedSampleData(DataStore& store) {
+  Customer c1{"C001", "Alice", "1380000", 1};
+  Customer c2{"C002", "Bob", "1370000", 0};
+  store.customers.push_back(c1);
+  store.customers.push_back(c2);
+
+  Vehicle v1{"VIN123", "渝A88888", "Toyota", "Corolla", 2020, c1.id, 42000};
+  Vehicle v2{"VIN456", "渝B66666", "Honda", "Civic", 2021, c2.id, 18000};
+  store.vehicles.push_back(v1);
+  store.vehicles.push_back(v2);
+
+  Technician t1; t1.id = "E100"; t1.name = "Bob"; t1.hourlyRate = 120;
+  Technician t2; t2.id = "E101"; t2.name = "Charlie"; t2.hourlyRate = 150;
+  store.technicians.push_back(t1);
+  store.technicians.push_back(t2);
+
+  ServiceAdvisor a1; a1.id = "E200"; a1.name = "Eve"; a1.baseSalary = 6000;
+  Manager m1; m1.id = "E300"; m1.name = "Grace"; m1.baseSalary = 10000;
+  store.advisors.push_back(a1);
+  store.managers.push_back(m1);
+
+  PartCsvRepository partRepo("data/parts.csv");
+  auto parts = partRepo.findAll();
+  if (parts.empty()) {
+    Part oil{"P001","Engine Oil",50,30,5,100};
+    Part filter{"P002","Oil Filter",30,25,4,80};
+    Part air{"P003","Air Filter",45,18,3,60};
+    Part brake{"P004","Brake Pads",120,10,2,40};
+    partRepo.save(oil);
+    partRepo.save(filter);
+    partRepo.save(air);
+    partRepo.save(brake);
+    parts = partRepo.findAll();
+  }
+  store.parts = parts;
+
+  WorkOrder wo;
+  wo.id = "WO0001";
+  wo.vehicle = v1;
+  wo.customer = c1;
+  wo.advisor.id = "E200";
+  wo.advisor.name = "Eve";
+  wo.lifecycle.created = StageStamp::now();
+  auto detection = MaintenanceDetector::detect(v1, store.parts);
+  wo.items = detection.items;
+  wo.detectionNote = detection.note;
+  wo.assign(t1);
+  store.lifecycleStats.observe(wo);
+  auto techIt = std::find_if(store.technicians.begin(), store.technicians.end(), [&](const Technician& t){ return t.id == t1.id; });
+  if (techIt != store.technicians.end()) techIt->assignedWorkOrders.push_back(IdTable::workOrders().intern(wo.id));
+  wo.start();
+  store.lifecycleStats.observe(wo);
+  wo.complete();
+  store.lifecycleStats.observe(wo);
+  wo.settle();
+  store.lifecycleStats.observe(wo);
+  store.serviceHistory.record(wo);
+  store.turnoverRollup.add(wo);
+  store.topN.record(wo, false); // the seed order does not draw on stock
+  store.workOrders.push_back(wo);
+  store.orderColumns.rebuild(store.workOrders);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+#include "domain/data_store.hpp"
+#include "persistence/data_store_persistence.hpp"
+#include "persistence/work_order_archive.hpp"
+
+// Produces the store the GUI starts with: the saved file (headers only,
+// items decoded on demand), sample data on first launch, and the seed
+// parts from data/parts.csv when the file has none. Safe to run off the
+// GUI thread; it touches no widgets.
+class StoreBootstrap {
+public:
+  static DataStore loadOrSeed(const std::string& dataPath, const DataStorePersistence::Progress& progress = {});
+  // Moves closed orders older than the store's archiveAfterDays into the
+  // archive, rebuilds the order columns and saves the store so the file
+  // and the archive agree. Every primary runs it after loading; a service
+  // built over the store needs setArchivedOrders and reindex afterwards.
+  // Returns how many orders moved.
+  static int archiveAged(DataStore& store, WorkOrderArchive& archive, const std::string& dataPath);
+  static void seedSampleData(DataStore& store);
+  // Fills an empty part catalog from data/parts.csv.
+  static void seedParts(DataStore& store);
+};
@@ -0,0 +1,188 @@
+#include "persistence/work_order_archive.hpp"
+#include "persistence/work_order_json.hpp"
+#include "trace/tracer.hpp"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <algorithm>
+#include <map>
+#include <set>
+
+namespace {
+constexpr std::int64_t kDayMs = 24LL * 60 * 60 * 1000;
+
+std::string monthOf(std::int64_t epochMs) {
+  return QDateTime::fromMSecsSinceEpoch(epochMs).toString("yyyy-MM").toStdString();
+}
+
+ArchiveSegmentInfo summarize(const std::string& month, const std::vector<WorkOrder>& orders) {
+  ArchiveSegmentInfo info;
+  info.month = month;
+  for (const auto& w : orders) {
+    info.orders++;
+    if (w.status == WOStatus::Paid) {
+      info.paid++;
+      info.turnover += w.previewTotal();
+    } else if (w.status == WOStatus::Cancelled) {
+      info.cancelled++;
+    }
+    if (info.firstId.empty() || w.id < info.firstId) info.firstId = w.id;
+    if (info.lastId.empty() || w.id > info.lastId) info.lastId = w.id;
+  }
+  return info;
+}
+}
+
+WorkOrderArchive::WorkOrderArchive(std::string directory) : dir_(std::move(directory)) {
+  loadIndex();
+}
+
+std::string WorkOrderArchive::directoryFor(const std::string& dataPath) {
+  return QFileInfo(QString::fromStdString(dataPath)).dir().filePath("archive").toStdString();
+}
+
+int WorkOrderArchive::sweep(std::vector<WorkOrder>& orders, int maxAgeDays, std::int64_t nowMs) {
+  if (maxAgeDays < 0) return 0;
+  const std::int64_t cutoff = nowMs - maxAgeDays * kDayMs;
+  auto aged = [&](const WorkOrder& w) { return isClosed(w.status) && w.closedAt > 0 && w.closedAt <= cutoff; };
+  if (std::none_of(orders.begin(), orders.end(), aged)) return 0;
+  TRACE_SCOPE("archive.sweep");
+
+  std::vector<WorkOrder> live;
+  live.reserve(orders.size());
+  std::map<std::string, std::vector<WorkOrder>> byMonth;
+  int moved = 0;
+  for (auto& w : orders) {
+    if (aged(w)) {
+      byMonth[monthOf(w.closedAt)].push_back(std::move(w));
+      moved++;
+    } else {
+      live.push_back(std::move(w));
+    }
+  }
+
+  QDir().mkpath(QString::fromStdString(dir_));
+  for (auto& [month, incoming] : byMonth) {
+    auto segment = loadSegment(month);
+    // An interrupted earlier sweep may have written the segment but not the store
+    std::set<std::string> present;
+    for (const auto& w : segment) present.insert(w.id);
+    for (const auto& w : incoming) {
+      if (present.insert(w.id).second) segment.push_back(w);
+    }
+    if (!writeSegment(month, segment)) {
+      // Keep the orders live rather than lose them
+      moved -= static_cast<int>(incoming.size());
+      for (auto& w : incoming) live.push_back(std::move(w));
+      continue;
+    }
+
+    auto info = summarize(month, segment);
+    auto it = std::lower_bound(index_.begin(), index_.end(), month,
+                               [](const ArchiveSegmentInfo& s, const std::string& m){ return s.month < m; });
+    if (it != index_.end() && it->month == month) *it = info;
+    else index_.insert(it, info);
+  }
+  if (moved > 0) saveIndex();
+  orders = std::move(live);
+  return moved;
+}
+
+int WorkOrderArchive::archivedCount() const {
+  int n = 0;
+  for (const auto& s : index_) n += s.orders;
+  return n;
+}
+
+int WorkOrderArchive::archivedPaidCount() const {
+  int n = 0;
+  for (const auto& s : index_) n += s.paid;
+  return n;
+}
+
+double WorkOrderArchive::archivedTurnover() const {
+  double total = 0;
+  for (const auto& s : index_) total += s.turnover;
+  return total;
+}
+
+std::vector<WorkOrder> WorkOrderArchive::loadSegment(const std::string& month, std::pmr::memory_resource* itemResource) const {
+  std::vector<WorkOrder> out;
+  QFile file(QString::fromStdString(segmentPath(month)));
+  if (!file.open(QIODevice::ReadOnly)) return out;
+  auto doc = QJsonDocument::fromJson(qUncompress(file.readAll()));
+  auto arr = doc.array();
+  out.reserve(arr.size());
+  for (const auto& v : arr) out.push_back(workOrderFromJson(v.toObject(), nullptr, itemResource));
+  return out;
+}
+
+void WorkOrderArchive::forEach(const std::function<void(const WorkOrder&)>& fn) const {
+  for (const auto& s : index_) {
+    // A segment's items are decoded into one arena and dropped together
+    std::pmr::monotonic_buffer_resource arena;
+    for (const auto& w : loadSegment(s.month, &arena)) fn(w);
+  }
+}
+
+std::optional<WorkOrder> WorkOrderArchive::find(const std::string& id) const {
+  for (const auto& s : index_) {
+    if (id < s.firstId || id > s.lastId) continue;
+    for (auto& w : loadSegment(s.month)) {
+      if (w.id == id) return std::move(w);
+    }
+  }
+  return std::nullopt;
+}
+
+std::string WorkOrderArchive::segmentPath(const std::string& month) const {
+  return QDir(QString::fromStdString(dir_)).filePath(QString::fromStdString(month + ".seg")).toStdString();
+}
+
+void WorkOrderArchive::loadIndex() {
+  index_.clear();
+  QFile file(QDir(QString::fromStdString(dir_)).filePath("index.json"));
+  if (!file.open(QIODevice::ReadOnly)) return;
+  auto doc = QJsonDocument::fromJson(file.readAll());
+  for (const auto& v : doc.object().value("segments").toArray()) {
+    auto o = v.toObject();
+    ArchiveSegmentInfo s;
+    s.month = o.value("month").toString().toStdString();
+    s.orders = o.value("orders").toInt();
+    s.paid = o.value("paid").toInt();
+    s.cancelled = o.value("cancelled").toInt();
+    s.turnover = o.value("turnover").toDouble();
+    s.firstId = o.value("firstId").toString().toStdString();
+    s.lastId = o.value("lastId").toString().toStdString();
+    index_.push_back(s);
+  }
+  std::sort(index_.begin(), index_.end(), [](const ArchiveSegmentInfo& a, const ArchiveSegmentInfo& b){ return a.month < b.month; });
+}
+
+void WorkOrderArchive::saveIndex() const {
+  QJsonArray segments;
+  for (const auto& s : index_) {
+    segments.push_back(QJsonObject{{"month", QString::fromStdString(s.month)}, {"orders", s.orders},
+                                   {"paid", s.paid}, {"cancelled", s.cancelled}, {"turnover", s.turnover},
+                                   {"firstId", QString::fromStdString(s.firstId)},
+                                   {"lastId", QString::fromStdString(s.lastId)}});
+  }
+  QSaveFile file(QDir(QString::fromStdString(dir_)).filePath("index.json"));
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return;
+  file.write(QJsonDocument(QJsonObject{{"segments", segments}}).toJson());
+  file.commit();
+}
+
+bool WorkOrderArchive::writeSegment(const std::string& month, const std::vector<WorkOrder>& orders) const {
+  QJsonArray arr;
+  for (const auto& w : orders) arr.push_back(workOrderToJson(w));
+  QSaveFile file(QString::fromStdString(segmentPath(month)));
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+  file.write(qCompress(QJsonDocument(arr).toJson(QJsonDocument::Compact)));
+  return file.commit();
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <vector>
+#include "domain/work_order.hpp"
+
+// Summary of one monthly archive segment, kept in the archive index so
+// reports can use totals without decompressing the segment itself.
+struct ArchiveSegmentInfo {
+  std::string month; // "yyyy-MM" of closedAt
+  int orders{0};
+  int paid{0};
+  int cancelled{0};
+  double turnover{0};
+  std::string firstId; // lexicographic id range, narrows find()
+  std::string lastId;
+};
+
+// Cold storage for closed (Paid/Cancelled) work orders. Orders are grouped by
+// the month they were closed into qCompress'ed segments next to a small
+// index.json; segments are only read when a report or lookup asks for them.
+class WorkOrderArchive {
+public:
+  explicit WorkOrderArchive(std::string directory);
+  // "archive" directory next to the data store file.
+  static std::string directoryFor(const std::string& dataPath);
+
+  // Moves closed orders older than maxAgeDays out of `orders` into their
+  // segments. Returns how many orders were archived.
+  int sweep(std::vector<WorkOrder>& orders, int maxAgeDays, std::int64_t nowMs);
+
+  const std::vector<ArchiveSegmentInfo>& segments() const { return index_; }
+  int archivedCount() const;
+  int archivedPaidCount() const;
+  double archivedTurnover() const;
+
+  std::vector<WorkOrder> loadSegment(const std::string& month,
+                                     std::pmr::memory_resource* itemResource = std::pmr::get_default_resource()) const;
+  // Visits every archived order, one segment in memory at a time.
+  void forEach(const std::function<void(const WorkOrder&)>& fn) const;
+  std::optional<WorkOrder> find(const std::string& id) const;
+
+private:
+  std::string dir_;
+  std::vector<ArchiveSegmentInfo> index_;
+
+  std::string segmentPath(const std::string& month) const;
+  void loadIndex();
+  void saveIndex() const;
+  bool writeSegment(const std::string& month, const std::vector<WorkOrder>& orders) const;
+};
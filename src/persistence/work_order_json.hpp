@@ -0,0 +1,30 @@
+#pragma once
+
+#include <QJsonObject>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include "domain/work_order.hpp"
+
+// JSON codec for work orders, shared by the data store file and the archive segments.
+QJsonObject workOrderToJson(const WorkOrder& w);
+// `source` is the raw buffer an "itemsRef" range points into (header-only
+// loads). Items are allocated from `itemResource`.
+WorkOrder workOrderFromJson(const QJsonObject& o, const std::shared_ptr<const std::string>& source = nullptr,
+                            std::pmr::memory_resource* itemResource = std::pmr::get_default_resource());
+
+// Codecs of the entities a work order embeds; the HTTP API uses them too.
+// The status names stored in files; writers without Qt strings use statusName
+const char* statusName(WOStatus st);
+QString statusToString(WOStatus st);
+WOStatus statusFromString(const QString& str);
+QJsonObject customerToJson(const Customer& c);
+Customer customerFromJson(const QJsonObject& o);
+QJsonObject vehicleToJson(const Vehicle& v);
+Vehicle vehicleFromJson(const QJsonObject& o);
+QJsonObject technicianToJson(const Technician& t);
+Technician technicianFromJson(const QJsonObject& o);
+QJsonObject partToJson(const Part& p);
+// A storehouse part, with the version that item copies of it leave out
+QJsonObject stockedPartToJson(const Part& p);
+Part partFromJson(const QJsonObject& o);
@@ -0,0 +1,68 @@
+#include "report/allocation_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifndef AUTO_REPAIR_COUNT_ALLOCATIONS
+#define AUTO_REPAIR_COUNT_ALLOCATIONS 0
+#endif
+
+namespace {
+std::atomic<std::size_t> g_liveBytes{0};
+std::atomic<std::size_t> g_allocations{0};
+}
+
+bool AllocationCounter::enabled() { return AUTO_REPAIR_COUNT_ALLOCATIONS != 0; }
+std::size_t AllocationCounter::liveBytes() { return g_liveBytes.load(std::memory_order_relaxed); }
+std::size_t AllocationCounter::allocations() { return g_allocations.load(std::memory_order_relaxed); }
+
+#if AUTO_REPAIR_COUNT_ALLOCATIONS
+namespace {
+// Keeps the size in front of the block, padded to max_align_t
+constexpr std::size_t kHeader = alignof(std::max_align_t);
+
+void* countedAlloc(std::size_t size) noexcept {
+  auto* block = static_cast<unsigned char*>(std::malloc(size + kHeader));
+  if (!block) return nullptr;
+  *reinterpret_cast<std::size_t*>(block) = size;
+  g_liveBytes.fetch_add(size, std::memory_order_relaxed);
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  return block + kHeader;
+}
+
+void countedFree(void* p) noexcept {
+  if (!p) return;
+  auto* block = static_cast<unsigned char*>(p) - kHeader;
+  g_liveBytes.fetch_sub(*reinterpret_cast<std::size_t*>(block), std::memory_order_relaxed);
+  std::free(block);
+}
+
+void* countedNew(std::size_t size) {
+  if (size == 0) size = 1;
+  for (;;) {
+    if (void* p = countedAlloc(size)) return p;
+    auto handler = std::get_new_handler();
+    if (!handler) throw std::bad_alloc();
+    handler();
+  }
+}
+}
+
+void* operator new(std::size_t size) { return countedNew(size); }
+void* operator new[](std::size_t size) { return countedNew(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return countedNew(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept { return operator new(size, tag); }
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { countedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+
+// Heap bytes in use, counted by replacements of the global operator
+// new/delete. They are compiled in only with the CMake option
+// AUTO_REPAIR_COUNT_ALLOCATIONS, which adds a 16-byte header and two atomic
+// updates to every allocation; otherwise enabled() is false and the counts
+// stay zero. Over-aligned allocations are not counted.
+class AllocationCounter {
+public:
+  static bool enabled();
+  static std::size_t liveBytes();   // requested bytes not yet freed
+  static std::size_t allocations(); // operator new calls so far
+};
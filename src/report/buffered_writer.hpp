@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Append-only file writer with a fixed-size buffer; memory use does not grow
+// with the amount written.
+class BufferedWriter {
+  std::FILE* file_{};
+  std::vector<char> buf_;
+  std::size_t used_{0};
+  bool ok_{false};
+
+public:
+  explicit BufferedWriter(const std::string& path, std::size_t capacity = 1 << 16)
+      : file_(std::fopen(path.c_str(), "wb")), buf_(capacity), ok_(file_ != nullptr) {}
+  ~BufferedWriter() { close(); }
+  BufferedWriter(const BufferedWriter&) = delete;
+  BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+  bool ok() const { return ok_; }
+
+  BufferedWriter& operator<<(std::string_view s) {
+    if (s.size() > buf_.size() - used_) {
+      flush();
+      if (s.size() > buf_.size()) {
+        write(s.data(), s.size());
+        return *this;
+      }
+    }
+    std::memcpy(buf_.data() + used_, s.data(), s.size());
+    used_ += s.size();
+    return *this;
+  }
+  BufferedWriter& operator<<(char c) {
+    if (used_ == buf_.size()) flush();
+    buf_[used_++] = c;
+    return *this;
+  }
+  BufferedWriter& operator<<(long long v) { return format("%lld", v); }
+  BufferedWriter& operator<<(int v) { return format("%d", v); }
+  // Money and other decimals are written with two fraction digits.
+  BufferedWriter& operator<<(double v) { return format("%.2f", v); }
+
+  // A CSV field, quoted with doubled quotes when it holds a separator,
+  // quote or line break
+  BufferedWriter& csvField(std::string_view v) {
+    if (v.find_first_of(",\"\r\n") == std::string_view::npos) return *this << v;
+    *this << '"';
+    for (char c : v) {
+      if (c == '"') *this << '"';
+      *this << c;
+    }
+    return *this << '"';
+  }
+
+  void flush() {
+    write(buf_.data(), used_);
+    used_ = 0;
+  }
+  bool close() {
+    if (!file_) return ok_;
+    flush();
+    ok_ = std::fclose(file_) == 0 && ok_;
+    file_ = nullptr;
+    return ok_;
+  }
+
+private:
+  template <typename T>
+  BufferedWriter& format(const char* fmt, T v) {
+    char tmp[64];
+    int n = std::snprintf(tmp, sizeof(tmp), fmt, v);
+    return *this << std::string_view(tmp, n > 0 ? static_cast<std::size_t>(n) : 0);
+  }
+  void write(const char* data, std::size_t n) {
+    if (file_ && n && std::fwrite(data, 1, n, file_) != n) ok_ = false;
+  }
+};
@@ -0,0 +1,90 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// HDR-style log-linear histogram of millisecond latencies. Values below 128
+// are exact; above that every power of two is split into 64 sub-buckets,
+// which keeps the relative error under 1.6% at any magnitude.
+class LatencyHistogram {
+  static constexpr int kSubBits = 6;
+  static constexpr std::int64_t kLinear = 2LL << kSubBits; // 128
+  static constexpr std::int64_t kSub = 1LL << kSubBits;    // 64
+
+  std::vector<std::uint64_t> counts_;
+  std::uint64_t total_{0};
+  std::int64_t min_{0}, max_{0};
+  long double sum_{0};
+
+public:
+  static std::size_t bucketOf(std::int64_t v) {
+    if (v < kLinear) return static_cast<std::size_t>(v < 0 ? 0 : v);
+    int msb = 63;
+    while (!(v >> msb)) --msb;
+    const int shift = msb - kSubBits;
+    return static_cast<std::size_t>(kLinear + (shift - 1) * kSub + ((v >> shift) - kSub));
+  }
+  // Smallest value that falls into `bucket`.
+  static std::int64_t lowerBound(std::size_t bucket) {
+    auto b = static_cast<std::int64_t>(bucket);
+    if (b < kLinear) return b;
+    const std::int64_t shift = (b - kLinear) / kSub + 1;
+    return (kSub + (b - kLinear) % kSub) << shift;
+  }
+
+  void record(std::int64_t valueMs) { addBucket(bucketOf(valueMs), 1, valueMs); }
+
+  // Restores a bucket count from persisted state.
+  void addBucket(std::size_t bucket, std::uint64_t count) { addBucket(bucket, count, lowerBound(bucket)); }
+
+  void merge(const LatencyHistogram& other) {
+    for (std::size_t i = 0; i < other.counts_.size(); ++i) {
+      if (other.counts_[i]) addBucket(i, other.counts_[i], lowerBound(i));
+    }
+    if (other.total_) {
+      min_ = std::min(min_, other.min_);
+      max_ = std::max(max_, other.max_);
+    }
+  }
+
+  std::uint64_t count() const { return total_; }
+  std::int64_t min() const { return min_; }
+  std::int64_t max() const { return max_; }
+  double mean() const { return total_ ? static_cast<double>(sum_ / total_) : 0.0; }
+
+  // Value at quantile q in [0, 1], reported as its bucket's lower bound.
+  std::int64_t percentile(double q) const {
+    if (!total_) return 0;
+    auto rank = static_cast<std::uint64_t>(q * static_cast<double>(total_ - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+      seen += counts_[i];
+      if (seen >= rank) return std::clamp(lowerBound(i), min_, max_);
+    }
+    return max_;
+  }
+
+  // Non-empty (bucket, count) pairs, for persistence.
+  std::vector<std::pair<std::size_t, std::uint64_t>> buckets() const {
+    std::vector<std::pair<std::size_t, std::uint64_t>> out;
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+      if (counts_[i]) out.emplace_back(i, counts_[i]);
+    }
+    return out;
+  }
+
+private:
+  void addBucket(std::size_t bucket, std::uint64_t count, std::int64_t value) {
+    if (bucket >= counts_.size()) counts_.resize(bucket + 1, 0);
+    counts_[bucket] += count;
+    if (total_ == 0) {
+      min_ = max_ = value;
+    } else {
+      min_ = std::min(min_, value);
+      max_ = std::max(max_, value);
+    }
+    total_ += count;
+    sum_ += static_cast<long double>(value) * count;
+  }
+};
@@ -0,0 +1,54 @@
+#include "report/lifecycle_stats.hpp"
+
+const char* stageName(Stage s) {
+  switch (s) {
+    case Stage::Intake: return "Intake";
+    case Stage::Waiting: return "Waiting";
+    case Stage::Repair: return "Repair";
+    case Stage::Checkout: return "Checkout";
+  }
+  return "Unknown";
+}
+
+void LifecycleStats::observe(const WorkOrder& order) {
+  const auto& lc = order.lifecycle;
+  auto closes = [&](Stage stage, const StageStamp& from, const StageStamp& to) {
+    if (from.recorded() && to.recorded()) record(stage, order, elapsedMs(from, to));
+  };
+  switch (order.status) {
+    case WOStatus::Assigned: closes(Stage::Intake, lc.created, lc.assigned); break;
+    case WOStatus::InProgress: closes(Stage::Waiting, lc.assigned, lc.started); break;
+    case WOStatus::Completed: closes(Stage::Repair, lc.started, lc.completed); break;
+    case WOStatus::Paid: closes(Stage::Checkout, lc.completed, lc.settled); break;
+    default: break;
+  }
+}
+
+void LifecycleStats::record(Stage stage, const WorkOrder& order, std::int64_t ms) {
+  overall_[static_cast<std::size_t>(stage)].record(ms);
+  if (!order.tech.id.empty()) byTech_[{stage, order.tech.id}].record(ms);
+  for (const auto& it : order.items) byService_[{stage, it.item.id}].record(ms);
+}
+
+void LifecycleStats::forEach(const std::function<void(Stage, const char*, const std::string&,
+                                                     const LatencyHistogram&)>& fn) const {
+  for (auto s : kStages) fn(s, "all", std::string(), overall(s));
+  for (const auto& [k, h] : byTech_) fn(k.first, "technician", k.second, h);
+  for (const auto& [k, h] : byService_) fn(k.first, "service", k.second, h);
+}
+
+void LifecycleStats::restoreBucket(Stage stage, const std::string& group, const std::string& key,
+                                   std::size_t bucket, std::uint64_t count) {
+  if (group == "technician") byTech_[{stage, key}].addBucket(bucket, count);
+  else if (group == "service") byService_[{stage, key}].addBucket(bucket, count);
+  else overall_[static_cast<std::size_t>(stage)].addBucket(bucket, count);
+}
+
+void LifecycleStats::writeCsv(std::ostream& out) const {
+  out << "stage,group,key,count,min_ms,p50_ms,p90_ms,p99_ms,max_ms,mean_ms\n";
+  forEach([&](Stage s, const char* group, const std::string& key, const LatencyHistogram& h) {
+    out << stageName(s) << ',' << group << ',' << key << ',' << h.count() << ',' << h.min() << ','
+        << h.percentile(0.5) << ',' << h.percentile(0.9) << ',' << h.percentile(0.99) << ','
+        << h.max() << ',' << h.mean() << '\n';
+  });
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <array>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include "domain/work_order.hpp"
+#include "report/latency_histogram.hpp"
+
+// Time spent in each stage between two lifecycle transitions.
+enum class Stage { Intake, Waiting, Repair, Checkout }; // created→assigned→started→completed→settled
+
+constexpr std::array<Stage, 4> kStages{Stage::Intake, Stage::Waiting, Stage::Repair, Stage::Checkout};
+const char* stageName(Stage s);
+
+// Streaming per-stage latency histograms, overall and split by technician
+// and by service item. Updated on every transition and persisted, so
+// readers never rescan orders.
+class LifecycleStats {
+public:
+  using Key = std::pair<Stage, std::string>;
+
+  // Records the stage that the order's latest transition just closed.
+  void observe(const WorkOrder& order);
+  void record(Stage stage, const WorkOrder& order, std::int64_t ms);
+
+  const LatencyHistogram& overall(Stage s) const { return overall_[static_cast<std::size_t>(s)]; }
+  const std::map<Key, LatencyHistogram>& byTechnician() const { return byTech_; }
+  const std::map<Key, LatencyHistogram>& byService() const { return byService_; }
+
+  // Visits every histogram; group is "all", "technician" or "service".
+  void forEach(const std::function<void(Stage, const char* group, const std::string& key,
+                                        const LatencyHistogram&)>& fn) const;
+  // Restores one persisted bucket of the histogram forEach reported.
+  void restoreBucket(Stage stage, const std::string& group, const std::string& key,
+                     std::size_t bucket, std::uint64_t count);
+
+  // stage,group,key,count,min,p50,p90,p99,max,mean (ms)
+  void writeCsv(std::ostream& out) const;
+
+private:
+  std::array<LatencyHistogram, 4> overall_;
+  std::map<Key, LatencyHistogram> byTech_;
+  std::map<Key, LatencyHistogram> byService_;
+};
@@ -0,0 +1,156 @@
+#include "report/memory_footprint.hpp"
+
+#include <cstdio>
+#include <unordered_set>
+
+namespace {
+bool onHeap(const std::string& s) {
+  const auto* object = reinterpret_cast<const char*>(&s);
+  return s.data() < object || s.data() >= object + sizeof(s);
+}
+
+std::size_t heapOf(const std::string& s) { return onHeap(s) ? s.capacity() + 1 : 0; }
+
+void addString(MemoryUsage& u, const std::string& s) {
+  const auto bytes = heapOf(s);
+  u.heapBytes += bytes;
+  u.stringBytes += bytes;
+}
+
+template <class T, class Alloc>
+void addVectorSlack(MemoryUsage& u, const std::vector<T, Alloc>& v) {
+  u.inlineBytes += v.capacity() * sizeof(T);
+  u.count += v.size();
+}
+
+void addPerson(MemoryUsage& u, const Person& p) {
+  addString(u, p.id);
+  addString(u, p.name);
+}
+
+void addCustomer(MemoryUsage& u, const Customer& c) {
+  addString(u, c.id);
+  addString(u, c.name);
+  addString(u, c.phone);
+}
+
+void addVehicle(MemoryUsage& u, const Vehicle& v) {
+  addString(u, v.vin);
+  addString(u, v.plate);
+  addString(u, v.brand);
+  addString(u, v.model);
+  addString(u, v.ownerId);
+}
+
+void addTechnician(MemoryUsage& u, const Technician& t) {
+  addPerson(u, t);
+  u.heapBytes += t.assignedWorkOrders.capacity() * sizeof(IdHandle);
+}
+
+void addPart(MemoryUsage& u, const Part& p) {
+  addString(u, p.id);
+  addString(u, p.name);
+}
+}
+
+MemoryReport MemoryFootprint::measure(const DataStore& store, const StoreHouse* storeHouse) {
+  MemoryUsage customers{"Customer"}, vehicles{"Vehicle"}, technicians{"Technician"}, advisors{"ServiceAdvisor"},
+      managers{"Manager"}, orders{"WorkOrder"}, items{"WOItem"}, itemParts{"Part (in WOItem)"},
+      catalog{"Part (DataStore)"}, stocked{"Part (StoreHouse)"}, pending{"Pending item JSON"};
+
+  addVectorSlack(customers, store.customers);
+  for (const auto& c : store.customers) addCustomer(customers, c);
+  addVectorSlack(vehicles, store.vehicles);
+  for (const auto& v : store.vehicles) addVehicle(vehicles, v);
+  addVectorSlack(technicians, store.technicians);
+  for (const auto& t : store.technicians) addTechnician(technicians, t);
+  addVectorSlack(advisors, store.advisors);
+  for (const auto& a : store.advisors) addPerson(advisors, a);
+  addVectorSlack(managers, store.managers);
+  for (const auto& m : store.managers) addPerson(managers, m);
+  addVectorSlack(catalog, store.parts);
+  for (const auto& p : store.parts) addPart(catalog, p);
+
+  // Header-only loads share one source buffer between many orders
+  std::unordered_set<const std::string*> sources;
+  addVectorSlack(orders, store.workOrders);
+  for (const auto& w : store.workOrders) {
+    // The embedded copies of vehicle, customer and staff count as the order's
+    addString(orders, w.id);
+    addVehicle(orders, w.vehicle);
+    addCustomer(orders, w.customer);
+    addPerson(orders, w.advisor);
+    addTechnician(orders, w.tech);
+    addString(orders, w.detectionNote);
+    if (w.pricing) orders.heapBytes += sizeof(CampaignPricing); // the largest strategy
+    if (w.pendingItems && w.pendingItems->source && sources.insert(w.pendingItems->source.get()).second) {
+      ++pending.count;
+      pending.heapBytes += heapOf(*w.pendingItems->source) + sizeof(std::string);
+      pending.stringBytes += heapOf(*w.pendingItems->source);
+    }
+
+    addVectorSlack(items, w.items);
+    for (const auto& item : w.items) {
+      addString(items, item.item.id);
+      addString(items, item.item.name);
+      addVectorSlack(itemParts, item.parts);
+      for (const auto& pr : item.parts) addPart(itemParts, pr.first);
+    }
+  }
+
+  std::vector<MemoryUsage> rows{customers, vehicles, technicians, advisors, managers, orders,
+                                items,     itemParts, catalog,    pending};
+  if (storeHouse) {
+    storeHouse->forEachPart([&](const std::string&, const Part& p) {
+      ++stocked.count;
+      addPart(stocked, p);
+    });
+    stocked.inlineBytes += storeHouse->indexBytes();
+    rows.push_back(stocked);
+  }
+
+  MemoryUsage interned{"Interned id"};
+  for (const auto* table : {&IdTable::parts(), &IdTable::technicians(), &IdTable::workOrders()}) {
+    // Name string plus libstdc++ index node: next pointer, key/value pair, cached hash
+    constexpr std::size_t kEntry =
+        sizeof(std::string) + sizeof(void*) + sizeof(std::pair<const std::string_view, IdHandle>) + sizeof(std::size_t);
+    interned.count += table->size();
+    interned.inlineBytes += table->size() * kEntry;
+  }
+  rows.push_back(interned);
+
+  MemoryReport report;
+  for (auto& r : rows) {
+    if (r.count > 0) report.rows.push_back(std::move(r));
+  }
+  return report;
+}
+
+std::size_t MemoryReport::total() const {
+  std::size_t sum = 0;
+  for (const auto& r : rows) sum += r.total();
+  return sum;
+}
+
+void MemoryReport::writeCsv(std::ostream& out) const {
+  out << "type,count,inline_bytes,heap_bytes,string_bytes,total_bytes,bytes_per_object\n";
+  for (const auto& r : rows) {
+    out << r.type << ',' << r.count << ',' << r.inlineBytes << ',' << r.heapBytes << ',' << r.stringBytes << ','
+        << r.total() << ',' << (r.count ? r.total() / r.count : 0) << '\n';
+  }
+  out << "total,,,,," << total() << ",\n";
+}
+
+void MemoryReport::writeTable(std::ostream& out) const {
+  char line[160];
+  std::snprintf(line, sizeof(line), "%-20s %10s %12s %12s %12s %12s %8s\n", "type", "count", "inline", "heap",
+                "strings", "total", "B/obj");
+  out << line;
+  for (const auto& r : rows) {
+    std::snprintf(line, sizeof(line), "%-20s %10zu %12zu %12zu %12zu %12zu %8zu\n", r.type.c_str(), r.count,
+                  r.inlineBytes, r.heapBytes, r.stringBytes, r.total(), r.count ? r.total() / r.count : 0);
+    out << line;
+  }
+  std::snprintf(line, sizeof(line), "%-20s %10s %12s %12s %12s %12zu\n", "total", "", "", "", "", total());
+  out << line;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "domain/data_store.hpp"
+#include "inventory/store_house.hpp"
+
+struct MemoryUsage {
+  std::string type;
+  std::size_t count{0};
+  std::size_t inlineBytes{0}; // the objects themselves, plus unused capacity of the vectors holding them
+  std::size_t heapBytes{0};   // strings and vectors they own
+  std::size_t stringBytes{0}; // the part of heapBytes owned by strings
+
+  std::size_t total() const { return inlineBytes + heapBytes; }
+};
+
+struct MemoryReport {
+  std::vector<MemoryUsage> rows;
+
+  std::size_t total() const;
+  void writeCsv(std::ostream& out) const;
+  void writeTable(std::ostream& out) const;
+};
+
+// Walks the store and the storehouse and adds up the bytes each entity type
+// takes, including heap capacity behind strings and vectors. Strings short
+// enough for the small-string buffer count as inline. Parts copied into
+// work order items are reported apart from the catalog. The process-wide id
+// intern tables are estimated from their size and reported with every
+// store, assuming ids fit the small-string buffer. Derived indexes
+// (columns, rollups, history) are not included. Allocator bookkeeping is
+// not seen here; AllocationCounter measures the real heap when enabled.
+class MemoryFootprint {
+public:
+  static MemoryReport measure(const DataStore& store, const StoreHouse* storeHouse = nullptr);
+};
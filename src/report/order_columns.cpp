@@ -0,0 +1,67 @@
+#include "report/order_columns.hpp"
+#include "trace/tracer.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+std::uint32_t StringDictionary::intern(const std::string& s) {
+  auto it = codes_.find(s);
+  if (it != codes_.end()) return it->second;
+  auto code = static_cast<std::uint32_t>(strings_.size());
+  strings_.push_back(s);
+  codes_.emplace(s, code);
+  return code;
+}
+
+void OrderColumns::rebuild(const std::vector<WorkOrder>& orders) {
+  TRACE_SCOPE("columns.rebuild");
+  status_.clear();
+  totalCents_.clear();
+  id_.clear();
+  technician_.clear();
+  customer_.clear();
+  createdAt_.clear();
+  closedAt_.clear();
+  version_.clear();
+  strings_.clear();
+
+  status_.reserve(orders.size());
+  totalCents_.reserve(orders.size());
+  id_.reserve(orders.size());
+  technician_.reserve(orders.size());
+  customer_.reserve(orders.size());
+  createdAt_.reserve(orders.size());
+  closedAt_.reserve(orders.size());
+  version_.reserve(orders.size());
+  for (std::size_t i = 0; i < orders.size(); ++i) sync(i, orders[i]);
+}
+
+void OrderColumns::sync(std::size_t row, const WorkOrder& order) {
+  if (row > size()) throw std::runtime_error("column row " + std::to_string(row) + " is past the end");
+  if (row == size()) {
+    status_.emplace_back();
+    totalCents_.emplace_back();
+    id_.emplace_back();
+    technician_.emplace_back();
+    customer_.emplace_back();
+    createdAt_.emplace_back();
+    closedAt_.emplace_back();
+    version_.emplace_back();
+  }
+  status_[row] = static_cast<std::uint8_t>(order.status);
+  totalCents_[row] = std::llround(order.previewTotal() * 100);
+  id_[row] = strings_.intern(order.id);
+  technician_[row] = strings_.intern(order.tech.id);
+  customer_[row] = strings_.intern(order.customer.id);
+  createdAt_[row] = order.lifecycle.created.wallMs;
+  closedAt_[row] = order.closedAt;
+  version_[row] = order.version;
+}
+
+bool OrderColumns::matches(const std::vector<WorkOrder>& orders) const {
+  if (orders.size() != size()) return false;
+  for (std::size_t i = 0; i < orders.size(); ++i) {
+    if (version_[i] != orders[i].version || strings_.at(id_[i]) != orders[i].id) return false;
+  }
+  return true;
+}
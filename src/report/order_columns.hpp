@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "domain/work_order.hpp"
+
+// Maps strings to dense 32-bit codes so columns can hold fixed-width values.
+class StringDictionary {
+public:
+  std::uint32_t intern(const std::string& s);
+  const std::string& at(std::uint32_t code) const { return strings_[code]; }
+  std::size_t size() const { return strings_.size(); }
+  void clear() { strings_.clear(); codes_.clear(); }
+
+private:
+  std::vector<std::string> strings_;
+  std::unordered_map<std::string, std::uint32_t> codes_;
+};
+
+// Struct-of-arrays projection of DataStore::workOrders for report scans.
+// Row i mirrors workOrders[i]; every column is a contiguous array of fixed
+// width values, so status and money scans touch no strings or pointers.
+// Callers keep it in sync: rebuild() after load or archival, sync() after
+// creating or changing one order.
+class OrderColumns {
+public:
+  OrderColumns() = default;
+  explicit OrderColumns(const std::vector<WorkOrder>& orders) { rebuild(orders); }
+
+  void rebuild(const std::vector<WorkOrder>& orders);
+  // Rewrites row `row`; row == size() appends. Throws std::runtime_error
+  // for a row past the end.
+  void sync(std::size_t row, const WorkOrder& order);
+
+  std::size_t size() const { return status_.size(); }
+  // True when every row holds the same order at the same version as
+  // `orders`, i.e. no order was added, replaced or changed without a sync.
+  bool matches(const std::vector<WorkOrder>& orders) const;
+
+  const std::vector<std::uint8_t>& status() const { return status_; }          // WOStatus
+  const std::vector<std::int64_t>& totalCents() const { return totalCents_; }  // previewTotal in cents
+  const std::vector<std::uint32_t>& id() const { return id_; }                 // dictionary codes
+  const std::vector<std::uint32_t>& technician() const { return technician_; }
+  const std::vector<std::uint32_t>& customer() const { return customer_; }
+  const std::vector<std::int64_t>& createdAt() const { return createdAt_; }    // epoch ms, 0 if unknown
+  const std::vector<std::int64_t>& closedAt() const { return closedAt_; }
+  const StringDictionary& strings() const { return strings_; }
+
+private:
+  std::vector<std::uint8_t> status_;
+  std::vector<std::int64_t> totalCents_;
+  std::vector<std::uint32_t> id_;
+  std::vector<std::uint32_t> technician_;
+  std::vector<std::uint32_t> customer_;
+  std::vector<std::int64_t> createdAt_;
+  std::vector<std::int64_t> closedAt_;
+  std::vector<std::uint64_t> version_; // WorkOrder::version when the row was synced
+  StringDictionary strings_;
+};
@@ -0,0 +1,112 @@
+#include "report/payroll.hpp"
+#include "report/buffered_writer.hpp"
+#include "report/turnover_rollup.hpp"
+#include "persistence/data_store_persistence.hpp"
+#include "persistence/work_order_archive.hpp"
+
+#include <cstdio>
+#include <unordered_map>
+
+namespace {
+const char* roleName(PayRole role) {
+  switch (role) {
+    case PayRole::Technician: return "technician";
+    case PayRole::Advisor: return "advisor";
+    case PayRole::Manager: return "manager";
+  }
+  return "";
+}
+
+std::string monthKey(int day) {
+  const int month = TurnoverRollup::monthOf(day);
+  char buf[16];
+  std::snprintf(buf, sizeof buf, "%04d-%02d", month / 12, month % 12 + 1);
+  return buf;
+}
+
+// Accumulates billed labor per technician for orders settled in the period.
+class LaborCollector {
+public:
+  LaborCollector(const std::vector<Technician>& techs, int fromDay, int toDay)
+      : hours_(techs.size(), 0.0), fromDay_(fromDay), toDay_(toDay) {
+    for (std::size_t i = 0; i < techs.size(); ++i) index_.emplace(techs[i].id, i);
+  }
+
+  void add(const WorkOrder& order) {
+    if (order.status != WOStatus::Paid || order.closedAt == 0) return;
+    const int day = TurnoverRollup::dayOf(order.closedAt);
+    if (day < fromDay_ || day > toDay_) return;
+    auto it = index_.find(order.tech.id);
+    if (it == index_.end()) return;
+    // Header-only orders decode just their items, into a scratch list
+    hours_[it->second] += order.hydrated() ? order.laborHours()
+                                           : WorkOrder::laborHours(DataStorePersistence::decodeItems(*order.pendingItems));
+  }
+
+  const std::vector<double>& hours() const { return hours_; }
+
+private:
+  std::unordered_map<std::string, std::size_t> index_;
+  std::vector<double> hours_;
+  int fromDay_;
+  int toDay_;
+};
+}
+
+PayrollRun PayrollEngine::run(const DataStore& store, int fromDay, int toDay, const WorkOrderArchive* archive) {
+  LaborCollector labor(store.technicians, fromDay, toDay);
+  for (const auto& w : store.workOrders) labor.add(w);
+  if (archive) {
+    // Only segments whose month overlaps the period are read
+    const std::string firstMonth = monthKey(fromDay);
+    const std::string lastMonth = monthKey(toDay);
+    for (const auto& s : archive->segments()) {
+      if (s.month < firstMonth || s.month > lastMonth) continue;
+      for (const auto& w : archive->loadSegment(s.month)) labor.add(w);
+    }
+  }
+
+  PayrollRun run;
+  run.fromDay = fromDay;
+  run.toDay = toDay;
+  run.lines.reserve(store.technicians.size() + store.advisors.size() + store.managers.size());
+
+  const auto& hours = labor.hours();
+  for (std::size_t i = 0; i < store.technicians.size(); ++i) {
+    const auto& t = store.technicians[i];
+    run.lines.push_back({t.id, t.name, PayRole::Technician, hours[i], t.hourlyRate, 0,
+                         Technician::pay(t.hourlyRate, hours[i])});
+  }
+  for (const auto& a : store.advisors) {
+    run.lines.push_back({a.id, a.name, PayRole::Advisor, 0, a.baseSalary, a.commission,
+                         ServiceAdvisor::pay(a.baseSalary, a.commission)});
+  }
+  for (const auto& m : store.managers) {
+    run.lines.push_back({m.id, m.name, PayRole::Manager, 0, m.baseSalary, m.bonus,
+                         Manager::pay(m.baseSalary, m.bonus)});
+  }
+  for (const auto& line : run.lines) run.total += line.pay;
+  return run;
+}
+
+bool PayrollEngine::writeCsv(const PayrollRun& run, const std::string& path) {
+  BufferedWriter out(path);
+  if (!out.ok()) return false;
+  out << "employee_id,name,role,hours,rate,variable,pay\n";
+  for (const auto& line : run.lines) {
+    out.csvField(line.employeeId) << ',';
+    out.csvField(line.name) << ',' << roleName(line.role) << ',' << line.hours << ',' << line.rate << ','
+                            << line.variable << ',' << line.pay << '\n';
+  }
+  out << "total,,,,,," << run.total << '\n';
+  return out.close();
+}
+
+std::string PayrollEngine::fileNameFor(int fromDay, int toDay) {
+  auto date = [](int day) {
+    char dd[4];
+    std::snprintf(dd, sizeof dd, "%02d", day - TurnoverRollup::firstDayOfMonth(TurnoverRollup::monthOf(day)) + 1);
+    return monthKey(day) + "-" + dd;
+  };
+  return "payroll_" + date(fromDay) + "_" + date(toDay) + ".csv";
+}
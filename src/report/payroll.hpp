@@ -0,0 +1,37 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "domain/data_store.hpp"
+
+class WorkOrderArchive;
+
+enum class PayRole { Technician, Advisor, Manager };
+
+struct PayrollLine {
+  std::string employeeId;
+  std::string name;
+  PayRole role{PayRole::Technician};
+  double hours{0};    // technicians only
+  double rate{0};     // hourly rate or base salary
+  double variable{0}; // commission or bonus
+  double pay{0};
+};
+
+struct PayrollRun {
+  int fromDay{0}; // inclusive local days, as in TurnoverRollup
+  int toDay{0};
+  std::vector<PayrollLine> lines; // technicians, then advisors, then managers
+  double total{0};
+};
+
+// Batch payroll over one period. Technician hours are the labor hours of
+// orders settled in the period; each employee type is then paid in its own
+// loop through the type's static pay formula, with no per-object virtual
+// dispatch.
+class PayrollEngine {
+public:
+  static PayrollRun run(const DataStore& store, int fromDay, int toDay, const WorkOrderArchive* archive = nullptr);
+  static bool writeCsv(const PayrollRun& run, const std::string& path);
+  // payroll_<yyyy-mm-dd>_<yyyy-mm-dd>.csv
+  static std::string fileNameFor(int fromDay, int toDay);
+};
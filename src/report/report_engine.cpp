@@ -0,0 +1,158 @@
+#include "report/report_engine.hpp"
+#include "report/report_service.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace {
+// Workers that outlive a reduction, so a report refreshed every tick does
+// not pay for starting threads. One reduction runs at a time; the caller
+// takes range 0 itself and the workers claim the rest.
+class WorkerPool {
+public:
+  static WorkerPool& instance() {
+    static WorkerPool pool;
+    return pool;
+  }
+
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& t : threads_) t.join();
+  }
+
+  // Calls work(0) .. work(n - 1) and returns once all have finished.
+  void run(std::size_t n, const std::function<void(std::size_t)>& work) {
+    if (n <= 1) {
+      if (n == 1) work(0);
+      return;
+    }
+    std::lock_guard<std::mutex> one(runMutex_);
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      while (threads_.size() < n - 1) threads_.emplace_back([this] { loop(); });
+      work_ = &work;
+      next_ = 1;
+      end_ = n;
+      pending_ = n - 1;
+    }
+    wake_.notify_all();
+    work(0);
+    std::unique_lock<std::mutex> guard(mutex_);
+    done_.wait(guard, [&] { return pending_ == 0; });
+    work_ = nullptr;
+  }
+
+private:
+  std::mutex runMutex_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  std::vector<std::thread> threads_;
+  const std::function<void(std::size_t)>* work_{};
+  std::size_t next_{0};
+  std::size_t end_{0};
+  std::size_t pending_{0};
+  bool stopping_{false};
+
+  void loop() {
+    std::unique_lock<std::mutex> guard(mutex_);
+    while (true) {
+      wake_.wait(guard, [&] { return stopping_ || next_ < end_; });
+      if (stopping_) return;
+      const std::size_t index = next_++;
+      const auto* work = work_;
+      guard.unlock();
+      (*work)(index);
+      guard.lock();
+      if (--pending_ == 0) done_.notify_one();
+    }
+  }
+};
+}
+
+void ReportPartial::add(const OrderColumns& columns, std::size_t begin, std::size_t end, bool collectIds) {
+  const std::uint8_t* status = columns.status().data();
+  const std::int64_t* cents = columns.totalCents().data();
+  constexpr auto paid = static_cast<std::uint8_t>(WOStatus::Paid);
+
+  // Branch-free so the compiler can vectorize the money scan
+  std::int64_t sum = 0;
+  int paidRows = 0;
+  for (std::size_t i = begin; i < end; ++i) {
+    const std::int64_t isPaid = status[i] == paid;
+    sum += cents[i] * isPaid;
+    paidRows += static_cast<int>(isPaid);
+  }
+  turnoverCents += sum;
+  paidCount += paidRows;
+
+  for (std::size_t i = begin; i < end; ++i) statusCounts[status[i]]++;
+  if (collectIds) {
+    // Dictionary codes, not strings: the scan allocates only as the lists grow
+    const std::uint32_t* ids = columns.id().data();
+    for (std::size_t s = 0; s < statusIds.size(); ++s) statusIds[s].reserve(statusIds[s].size() + statusCounts[s]);
+    for (std::size_t i = begin; i < end; ++i) statusIds[status[i]].push_back(ids[i]);
+  }
+}
+
+void ReportPartial::merge(ReportPartial&& other) {
+  for (std::size_t s = 0; s < statusIds.size(); ++s) {
+    auto& dst = statusIds[s];
+    auto& src = other.statusIds[s];
+    if (dst.empty()) dst = std::move(src);
+    else dst.insert(dst.end(), src.begin(), src.end());
+  }
+  for (std::size_t s = 0; s < statusCounts.size(); ++s) statusCounts[s] += other.statusCounts[s];
+  turnoverCents += other.turnoverCents;
+  paidCount += other.paidCount;
+}
+
+ReportPartial ReportEngine::reduce(const OrderColumns& columns, bool collectIds, unsigned threads) {
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  const std::size_t maxUseful = std::max<std::size_t>(1, columns.size() / kMinOrdersPerThread);
+  const std::size_t parts = std::min<std::size_t>(threads, maxUseful);
+
+  std::vector<ReportPartial> partials(parts);
+  WorkerPool::instance().run(parts, [&](std::size_t p) {
+    const std::size_t begin = columns.size() * p / parts;
+    const std::size_t end = columns.size() * (p + 1) / parts;
+    partials[p].add(columns, begin, end, collectIds);
+  });
+
+  for (std::size_t p = 1; p < parts; ++p) partials[0].merge(std::move(partials[p]));
+  return std::move(partials[0]);
+}
+
+FinalReport ReportEngine::summarize(const OrderColumns& columns, const std::vector<Part>& inventory,
+                                    unsigned threads, bool collectIds) {
+  auto total = reduce(columns, collectIds, threads);
+  FinalReport r;
+  r.inventory = &inventory;
+  r.paidCount = total.paidCount;
+  r.turnover = static_cast<double>(total.turnoverCents) / 100;
+  r.statusCounts = total.statusCounts;
+  for (std::size_t s = 0; s < total.statusIds.size(); ++s) {
+    const auto& codes = total.statusIds[s];
+    if (codes.empty()) continue;
+    auto& ids = r.statusBuckets[static_cast<WOStatus>(s)];
+    ids.reserve(codes.size());
+    for (auto code : codes) ids.push_back(columns.strings().at(code));
+  }
+  return r;
+}
+
+ReportPartial ReportEngine::totals(const OrderColumns& columns, unsigned threads) {
+  return reduce(columns, false, threads);
+}
+
+TurnoverReport ReportEngine::turnover(const OrderColumns& columns, unsigned threads) {
+  auto total = reduce(columns, false, threads);
+  return TurnoverReport{static_cast<double>(total.turnoverCents) / 100, total.paidCount};
+}
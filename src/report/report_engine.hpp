@@ -0,0 +1,46 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "domain/work_order.hpp"
+#include "report/order_columns.hpp"
+
+struct FinalReport;
+struct TurnoverReport;
+
+// Aggregate of one contiguous partition of the order list. Money is summed
+// in integer cents so merged totals do not depend on the partitioning.
+struct ReportPartial {
+  std::array<std::vector<std::uint32_t>, 6> statusIds; // id dictionary codes, indexed by WOStatus
+  std::array<int, 6> statusCounts{};
+  std::int64_t turnoverCents{0};
+  int paidCount{0};
+
+  // Scans rows [begin, end) of the columns.
+  void add(const OrderColumns& columns, std::size_t begin, std::size_t end, bool collectIds);
+  void merge(ReportPartial&& other);
+};
+
+// Parallel reduction over the columnar order projection: rows are split into
+// one contiguous range per thread, each thread fills its own ReportPartial,
+// and partials are merged in range order so the result is identical for any
+// thread count. Ranges run on a pool of workers kept across calls.
+class ReportEngine {
+public:
+  // threads == 0 picks hardware concurrency, capped so every range has
+  // at least kMinOrdersPerThread orders. Order ids per status are only
+  // listed with collectIds; counts and turnover are always filled in.
+  static FinalReport summarize(const OrderColumns& columns, const std::vector<Part>& inventory,
+                               unsigned threads = 0, bool collectIds = false);
+  // The report keeps a pointer to the inventory, so it must not be a temporary
+  static FinalReport summarize(const OrderColumns&, std::vector<Part>&&, unsigned = 0, bool = false) = delete;
+  static TurnoverReport turnover(const OrderColumns& columns, unsigned threads = 0);
+  // Counts and turnover without collecting ids.
+  static ReportPartial totals(const OrderColumns& columns, unsigned threads = 0);
+
+  static constexpr std::size_t kMinOrdersPerThread = 4096;
+
+private:
+  static ReportPartial reduce(const OrderColumns& columns, bool collectIds, unsigned threads);
+};
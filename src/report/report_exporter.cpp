@@ -0,0 +1,176 @@
+#include "report/report_exporter.hpp"
+#include "report/buffered_writer.hpp"
+#include "report/report_engine.hpp"
+#include "report/report_service.hpp"
+#include "persistence/work_order_archive.hpp"
+#include "persistence/work_order_json.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <memory>
+
+namespace {
+enum class Section { None, Turnover, Statuses, Inventory, Orders };
+
+// Format-specific output; the driver below calls these in section order.
+class ReportWriter {
+public:
+  explicit ReportWriter(BufferedWriter& out) : out_(out) {}
+  virtual ~ReportWriter() = default;
+  virtual void turnover(const TurnoverReport& all, int archivedOrders) = 0;
+  virtual void status(WOStatus st, int count) = 0;
+  virtual void part(const Part& p) = 0;
+  virtual void order(const WorkOrder& w, bool archived) = 0;
+  virtual void finish() = 0;
+
+protected:
+  BufferedWriter& out_;
+  Section section_{Section::None};
+};
+
+class CsvWriter final : public ReportWriter {
+public:
+  using ReportWriter::ReportWriter;
+  void turnover(const TurnoverReport& all, int archivedOrders) override {
+    out_ << "paid_orders,turnover,archived_orders\n" << all.count << ',' << all.total << ',' << archivedOrders << '\n';
+  }
+  void status(WOStatus st, int count) override {
+    enter(Section::Statuses, "status,count\n");
+    out_ << statusName(st) << ',' << count << '\n';
+  }
+  void part(const Part& p) override {
+    enter(Section::Inventory, "part_id,name,unit_price,stock,reorder_point,capacity\n");
+    field(p.id) << ',';
+    field(p.name) << ',' << p.unitPrice << ',' << p.stock << ',' << p.reorderPoint << ',' << p.capacity << '\n';
+  }
+  void order(const WorkOrder& w, bool archived) override {
+    enter(Section::Orders, "id,plate,vin,customer,technician,status,total,closed_at,archived\n");
+    field(w.id) << ',';
+    field(w.vehicle.plate) << ',';
+    field(w.vehicle.vin) << ',';
+    field(w.customer.name) << ',';
+    field(w.tech.name) << ',' << statusName(w.status) << ',' << w.previewTotal() << ','
+                       << static_cast<long long>(w.closedAt) << ',' << (archived ? "1" : "0") << '\n';
+  }
+  void finish() override {}
+
+private:
+  void enter(Section s, const char* header) {
+    if (section_ == s) return;
+    section_ = s;
+    out_ << '\n' << header;
+  }
+  BufferedWriter& field(const std::string& v) { return out_.csvField(v); }
+};
+
+class JsonWriter final : public ReportWriter {
+public:
+  using ReportWriter::ReportWriter;
+  void turnover(const TurnoverReport& all, int archivedOrders) override {
+    out_ << "{\n\"turnover\": {\"paidOrders\": " << all.count << ", \"turnover\": " << all.total
+         << ", \"archivedOrders\": " << archivedOrders << "}";
+  }
+  void status(WOStatus st, int count) override {
+    enter(Section::Statuses, "statuses");
+    out_ << "{\"status\": \"" << statusName(st) << "\", \"count\": " << count << '}';
+  }
+  void part(const Part& p) override {
+    enter(Section::Inventory, "inventory");
+    out_ << "{\"id\": ";
+    str(p.id) << ", \"name\": ";
+    str(p.name) << ", \"unitPrice\": " << p.unitPrice << ", \"stock\": " << p.stock
+                << ", \"reorderPoint\": " << p.reorderPoint << ", \"capacity\": " << p.capacity << '}';
+  }
+  void order(const WorkOrder& w, bool archived) override {
+    enter(Section::Orders, "orders");
+    out_ << "{\"id\": ";
+    str(w.id) << ", \"plate\": ";
+    str(w.vehicle.plate) << ", \"vin\": ";
+    str(w.vehicle.vin) << ", \"customer\": ";
+    str(w.customer.name) << ", \"technician\": ";
+    str(w.tech.name) << ", \"status\": \"" << statusName(w.status) << "\", \"total\": " << w.previewTotal()
+                     << ", \"closedAt\": " << static_cast<long long>(w.closedAt)
+                     << ", \"archived\": " << (archived ? "true" : "false") << '}';
+  }
+  void finish() override {
+    if (section_ != Section::None) out_ << "\n]";
+    out_ << "\n}\n";
+  }
+
+private:
+  void enter(Section s, const char* key) {
+    if (section_ == s) {
+      out_ << ",\n";
+      return;
+    }
+    if (section_ != Section::None) out_ << "\n]";
+    section_ = s;
+    out_ << ",\n\"" << key << "\": [\n";
+  }
+  BufferedWriter& str(const std::string& v) {
+    out_ << '"';
+    for (char c : v) {
+      switch (c) {
+        case '"': out_ << "\\\""; break;
+        case '\\': out_ << "\\\\"; break;
+        case '\n': out_ << "\\n"; break;
+        case '\r': out_ << "\\r"; break;
+        case '\t': out_ << "\\t"; break;
+        default:
+          if (static_cast<unsigned char>(c) < 0x20) {
+            char esc[8];
+            std::snprintf(esc, sizeof(esc), "\\u%04x", c);
+            out_ << esc;
+          } else {
+            out_ << c;
+          }
+      }
+    }
+    return out_ << '"';
+  }
+};
+}
+
+ReportExporter::Format ReportExporter::formatFor(const std::string& path) {
+  auto dot = path.rfind('.');
+  std::string ext = dot == std::string::npos ? std::string() : path.substr(dot + 1);
+  std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c){ return static_cast<char>(std::tolower(c)); });
+  return ext == "json" ? Format::Json : Format::Csv;
+}
+
+bool ReportExporter::exportTo(const std::string& path, const DataStore& store, const WorkOrderArchive* archive) {
+  return exportTo(path, formatFor(path), store, archive);
+}
+
+bool ReportExporter::exportTo(const std::string& path, Format format, const DataStore& store,
+                              const WorkOrderArchive* archive) {
+  BufferedWriter out(path);
+  if (!out.ok()) return false;
+  std::unique_ptr<ReportWriter> writer;
+  if (format == Format::Json) writer = std::make_unique<JsonWriter>(out);
+  else writer = std::make_unique<CsvWriter>(out);
+
+  auto live = store.orderColumns.matches(store.workOrders) ? ReportEngine::totals(store.orderColumns)
+                                                           : ReportEngine::totals(OrderColumns(store.workOrders));
+  std::array<int, 6> counts = live.statusCounts;
+  TurnoverReport all{static_cast<double>(live.turnoverCents) / 100, live.paidCount};
+  int archivedOrders = 0;
+  if (archive) {
+    for (const auto& s : archive->segments()) {
+      counts[static_cast<std::size_t>(WOStatus::Paid)] += s.paid;
+      counts[static_cast<std::size_t>(WOStatus::Cancelled)] += s.cancelled;
+    }
+    all.total += archive->archivedTurnover();
+    all.count += archive->archivedPaidCount();
+    archivedOrders = archive->archivedCount();
+  }
+
+  writer->turnover(all, archivedOrders);
+  for (std::size_t s = 0; s < counts.size(); ++s) writer->status(static_cast<WOStatus>(s), counts[s]);
+  for (const auto& p : store.parts) writer->part(p);
+  for (const auto& w : store.workOrders) writer->order(w, false);
+  if (archive) archive->forEach([&](const WorkOrder& w) { writer->order(w, true); });
+  writer->finish();
+  return out.close();
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <string>
+#include "domain/data_store.hpp"
+
+class WorkOrderArchive;
+
+// Streams a full report (turnover, status breakdown, inventory and one line
+// per order) straight to a file. Nothing is collected in memory first;
+// archived orders are read one segment at a time.
+class ReportExporter {
+public:
+  enum class Format { Csv, Json };
+
+  // Format from the file extension: .json for JSON, CSV otherwise.
+  static Format formatFor(const std::string& path);
+  static bool exportTo(const std::string& path, const DataStore& store, const WorkOrderArchive* archive);
+  static bool exportTo(const std::string& path, Format format, const DataStore& store,
+                       const WorkOrderArchive* archive);
+};
@@ -1,10 +1,14 @@
 
 #pragma once
+#include <array>
 #include <vector>
 #include <string>
 #include <map>
 #include "domain/work_order.hpp"
 #include "domain/part.hpp"
+#include "report/turnover_rollup.hpp"
+#include "report/report_engine.hpp"
+#include "report/top_n.hpp"
 
 struct TurnoverReport {
   double total{0};
@@ -14,33 +18,40 @@ struct TurnoverReport {
 struct FinalReport {
   double turnover{0};
   int paidCount{0};
-  std::map<WOStatus, std::vector<std::string>> statusBuckets;
-  std::vector<Part> inventory;
+  std::array<int, 6> statusCounts{}; // indexed by WOStatus
+  std::map<WOStatus, std::vector<std::string>> statusBuckets; // only when ids were asked for
+  const std::vector<Part>* inventory{}; // not owned; the caller's vector must outlive the report
 };
 
 class ReportService {
 public:
+  static TurnoverReport turnover(const OrderColumns& columns) {
+    return ReportEngine::turnover(columns);
+  }
+  // Ad hoc order lists are projected to columns first; DataStore keeps its own.
   static TurnoverReport turnover(const std::vector<WorkOrder>& orders) {
-    TurnoverReport r;
-    for (const auto& o : orders) {
-      if (o.status == WOStatus::Paid) {
-        r.total += o.previewTotal();
-        r.count++;
-      }
-    }
-    return r;
+    return ReportEngine::turnover(OrderColumns(orders));
+  }
+
+  // Turnover over an inclusive range of local days, answered from the rollup.
+  static TurnoverReport turnover(const TurnoverRollup& rollup, int fromDay, int toDay, const std::string& techId = {}) {
+    auto cell = rollup.query(fromDay, toDay, techId);
+    return TurnoverReport{cell.turnover, cell.orders};
   }
 
-  static FinalReport summary(const std::vector<WorkOrder>& orders, const std::vector<Part>& inventory) {
-    FinalReport r;
-    r.inventory = inventory;
-    for (const auto& o : orders) {
-      r.statusBuckets[o.status].push_back(o.id);
-      if (o.status == WOStatus::Paid) {
-        r.paidCount++;
-        r.turnover += o.previewTotal();
-      }
-    }
-    return r;
+  // Leaderboards, O(N log k) over the distinct ids of each kind.
+  static std::vector<RankedEntry> topParts(const TopNTracker& t, std::size_t k) { return t.partsByQuantity.top(k); }
+  static std::vector<RankedEntry> topCustomers(const TopNTracker& t, std::size_t k) { return t.customersByRevenue.top(k); }
+  static std::vector<RankedEntry> topTechnicians(const TopNTracker& t, std::size_t k) { return t.techniciansByOrders.top(k); }
+
+  static FinalReport summary(const OrderColumns& columns, const std::vector<Part>& inventory, bool collectIds = false) {
+    return ReportEngine::summarize(columns, inventory, 0, collectIds);
+  }
+  static FinalReport summary(const std::vector<WorkOrder>& orders, const std::vector<Part>& inventory,
+                             bool collectIds = false) {
+    return ReportEngine::summarize(OrderColumns(orders), inventory, 0, collectIds);
   }
+  // FinalReport::inventory would dangle
+  static FinalReport summary(const OrderColumns&, std::vector<Part>&&, bool = false) = delete;
+  static FinalReport summary(const std::vector<WorkOrder>&, std::vector<Part>&&, bool = false) = delete;
 };
@@ -0,0 +1,45 @@
+#include "report/top_n.hpp"
+
+#include <algorithm>
+#include <queue>
+
+namespace {
+// "a ranks above b"
+bool ranksAbove(const RankedEntry& a, const RankedEntry& b) {
+  return a.value != b.value ? a.value > b.value : a.key < b.key;
+}
+}
+
+std::vector<RankedEntry> TopCounter::top(std::size_t k) const {
+  if (k == 0) return {};
+  // Min-heap of the best k seen so far; its top is the weakest of them
+  auto weaker = [](const RankedEntry& a, const RankedEntry& b) { return ranksAbove(a, b); };
+  std::priority_queue<RankedEntry, std::vector<RankedEntry>, decltype(weaker)> heap(weaker);
+  for (const auto& [key, value] : totals_) {
+    RankedEntry e{key, value};
+    if (heap.size() < k) {
+      heap.push(std::move(e));
+    } else if (ranksAbove(e, heap.top())) {
+      heap.pop();
+      heap.push(std::move(e));
+    }
+  }
+  std::vector<RankedEntry> out;
+  out.reserve(heap.size());
+  while (!heap.empty()) {
+    out.push_back(heap.top());
+    heap.pop();
+  }
+  std::reverse(out.begin(), out.end());
+  return out;
+}
+
+void TopNTracker::record(const WorkOrder& order, bool partsConsumed) {
+  if (order.status != WOStatus::Paid) return;
+  if (!order.customer.id.empty()) customersByRevenue.add(order.customer.id, order.previewTotal());
+  if (!order.tech.id.empty()) techniciansByOrders.add(order.tech.id, 1);
+  if (!partsConsumed) return;
+  for (const auto& it : order.items) {
+    for (const auto& pr : it.parts) partsByQuantity.add(pr.first.id, pr.second);
+  }
+}
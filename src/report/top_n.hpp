@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "domain/work_order.hpp"
+
+struct RankedEntry {
+  std::string key;
+  double value{0};
+};
+
+// Running totals per key with a bounded-heap top-k query: O(N log k) over N
+// distinct keys. Keys are entity ids (parts, customers, technicians), so
+// exact counters stay small and no sketch approximation is needed.
+class TopCounter {
+public:
+  void add(const std::string& key, double amount) { totals_[key] += amount; }
+  // Highest values first; ties break on key so results are stable.
+  std::vector<RankedEntry> top(std::size_t k) const;
+  const std::unordered_map<std::string, double>& totals() const { return totals_; }
+
+private:
+  std::unordered_map<std::string, double> totals_;
+};
+
+// Leaderboards maintained as orders settle.
+struct TopNTracker {
+  TopCounter partsByQuantity;     // part id -> units consumed
+  TopCounter customersByRevenue;  // customer id -> paid turnover
+  TopCounter techniciansByOrders; // technician id -> settled orders
+
+  // partsConsumed is false when the storehouse could not supply the parts.
+  void record(const WorkOrder& order, bool partsConsumed);
+};
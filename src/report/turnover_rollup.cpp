@@ -0,0 +1,163 @@
+#include "report/turnover_rollup.hpp"
+
+#include <algorithm>
+#include <ctime>
+
+namespace {
+// Proleptic Gregorian conversions (H. Hinnant's days_from_civil/civil_from_days)
+int daysFromCivil(int y, int m, int d) {
+  y -= m <= 2;
+  const int era = (y >= 0 ? y : y - 399) / 400;
+  const int yoe = y - era * 400;
+  const int doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+  const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+void civilFromDays(int z, int& y, int& m, int& d) {
+  z += 719468;
+  const int era = (z >= 0 ? z : z - 146096) / 146097;
+  const int doe = z - era * 146097;
+  const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const int mp = (5 * doy + 2) / 153;
+  d = doy - (153 * mp + 2) / 5 + 1;
+  m = mp < 10 ? mp + 3 : mp - 9;
+  y = yoe + era * 400 + (m <= 2);
+}
+
+int floorDiv(int a, int b) { return a / b - ((a % b != 0) && ((a < 0) != (b < 0))); }
+
+double listPrice(const WOItem& it, double techHourly) {
+  double h = (it.laborHoursOverride > 0 ? it.laborHoursOverride : it.item.laborHours);
+  double line = it.item.basePrice + h * techHourly;
+  for (const auto& pr : it.parts) line += pr.first.unitPrice * pr.second;
+  return line;
+}
+}
+
+int TurnoverRollup::dayOf(std::int64_t epochMs) {
+  std::time_t tt = static_cast<std::time_t>(epochMs / 1000);
+  std::tm local{};
+#ifdef _WIN32
+  localtime_s(&local, &tt);
+#else
+  localtime_r(&tt, &local);
+#endif
+  return dayFromDate(1900 + local.tm_year, local.tm_mon + 1, local.tm_mday);
+}
+
+int TurnoverRollup::dayFromDate(int year, int month, int day) { return daysFromCivil(year, month, day); }
+
+int TurnoverRollup::weekOf(int day) { return floorDiv(day + 3, 7); }
+
+int TurnoverRollup::monthOf(int day) {
+  int y, m, d;
+  civilFromDays(day, y, m, d);
+  return y * 12 + (m - 1);
+}
+
+// Day 0 (1970-01-01) was a Thursday
+int TurnoverRollup::firstDayOfWeek(int week) { return week * 7 - 3; }
+
+int TurnoverRollup::firstDayOfMonth(int month) {
+  return daysFromCivil(floorDiv(month, 12), month - floorDiv(month, 12) * 12 + 1, 1);
+}
+
+void TurnoverRollup::add(const WorkOrder& order) {
+  if (order.status != WOStatus::Paid || order.closedAt == 0) return;
+  const int day = dayOf(order.closedAt);
+  const double total = order.previewTotal();
+  addCell({day, order.tech.id, std::string()}, {total, 1});
+
+  double listSum = 0;
+  for (const auto& it : order.items) listSum += listPrice(it, order.tech.hourlyRate);
+  // Items of the same service share one cell, so the order counts once per service
+  std::map<std::string, double> shares;
+  for (const auto& it : order.items)
+    shares[it.item.id] += listSum > 0 ? total * listPrice(it, order.tech.hourlyRate) / listSum : 0;
+  for (const auto& [serviceId, share] : shares) addCell({day, order.tech.id, serviceId}, {share, 1});
+}
+
+void TurnoverRollup::addDayCell(int day, const std::string& techId, const std::string& serviceId, const RollupCell& cell) {
+  addCell({day, techId, serviceId}, cell);
+}
+
+void TurnoverRollup::addCell(const Key& dayKey, const RollupCell& cell) {
+  const int day = std::get<0>(dayKey);
+  const int buckets[3] = {day, weekOf(day), monthOf(day)};
+  for (int g = 0; g < 3; ++g) {
+    auto& c = tables_[g][{buckets[g], std::get<1>(dayKey), std::get<2>(dayKey)}];
+    c.turnover += cell.turnover;
+    c.orders += cell.orders;
+  }
+}
+
+void TurnoverRollup::accumulate(Granularity g, int bucket, const std::string& techId, const std::string& serviceId,
+                                const Visitor& fn) const {
+  const auto& table = tables_[static_cast<int>(g)];
+  for (auto it = table.lower_bound({bucket, techId, std::string()}); it != table.end(); ++it) {
+    const auto& [b, tech, service] = it->first;
+    if (b != bucket || (!techId.empty() && tech != techId)) break;
+    if (service == serviceId) fn(tech, it->second);
+  }
+}
+
+void TurnoverRollup::visitRange(int fromDay, int toDay, const std::string& techId, const std::string& serviceId,
+                                const Visitor& fn) const {
+  for (int d = fromDay; d <= toDay;) {
+    const int month = monthOf(d);
+    const int nextMonth = firstDayOfMonth(month + 1);
+    if (d == firstDayOfMonth(month) && nextMonth - 1 <= toDay) {
+      accumulate(Granularity::Month, month, techId, serviceId, fn);
+      d = nextMonth;
+      continue;
+    }
+    // A week must not swallow the first days of a month that fits whole
+    const bool blocksMonth = d + 6 >= nextMonth && firstDayOfMonth(month + 2) - 1 <= toDay;
+    if (firstDayOfWeek(weekOf(d)) == d && d + 6 <= toDay && !blocksMonth) {
+      accumulate(Granularity::Week, weekOf(d), techId, serviceId, fn);
+      d += 7;
+      continue;
+    }
+    accumulate(Granularity::Day, d, techId, serviceId, fn);
+    ++d;
+  }
+}
+
+RollupCell TurnoverRollup::query(int fromDay, int toDay, const std::string& techId, const std::string& serviceId) const {
+  RollupCell out;
+  visitRange(fromDay, toDay, techId, serviceId, [&](const std::string&, const RollupCell& c) {
+    out.turnover += c.turnover;
+    out.orders += c.orders;
+  });
+  return out;
+}
+
+std::map<std::string, RollupCell> TurnoverRollup::byTechnician(int fromDay, int toDay) const {
+  std::map<std::string, RollupCell> out;
+  visitRange(fromDay, toDay, std::string(), std::string(), [&](const std::string& tech, const RollupCell& c) {
+    out[tech].turnover += c.turnover;
+    out[tech].orders += c.orders;
+  });
+  return out;
+}
+
+std::vector<std::pair<int, RollupCell>> TurnoverRollup::series(Granularity g, int fromDay, int toDay,
+                                                               const std::string& techId) const {
+  std::vector<std::pair<int, RollupCell>> out;
+  for (int d = fromDay; d <= toDay;) {
+    int bucket = d, end = d;
+    if (g == Granularity::Week) {
+      bucket = weekOf(d);
+      end = firstDayOfWeek(bucket) + 6;
+    } else if (g == Granularity::Month) {
+      bucket = monthOf(d);
+      end = firstDayOfMonth(bucket + 1) - 1;
+    }
+    end = std::min(end, toDay);
+    out.emplace_back(bucket, query(d, end, techId));
+    d = end + 1;
+  }
+  return out;
+}
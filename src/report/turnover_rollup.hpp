@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "domain/work_order.hpp"
+
+enum class Granularity { Day, Week, Month };
+
+struct RollupCell {
+  double turnover{0};
+  int orders{0};
+};
+
+// Pre-aggregated turnover of paid orders by day, week and month, each split
+// by technician and service item. Settling an order touches a handful of
+// cells; a date range query merges whole months and weeks plus the leftover
+// days, so its cost depends on the range length, not on the order count.
+class TurnoverRollup {
+public:
+  // (bucket, technician id, service id); service id "" holds whole-order totals
+  using Key = std::tuple<int, std::string, std::string>;
+
+  // Adds a paid order, attributing its total to items by their list price.
+  void add(const WorkOrder& order);
+  // Adds one day cell directly (used when restoring persisted rollups).
+  void addDayCell(int day, const std::string& techId, const std::string& serviceId, const RollupCell& cell);
+
+  // Inclusive range of local days; empty techId/serviceId match any.
+  RollupCell query(int fromDay, int toDay, const std::string& techId = {}, const std::string& serviceId = {}) const;
+  // Per-technician whole-order totals over a day range.
+  std::map<std::string, RollupCell> byTechnician(int fromDay, int toDay) const;
+  // One cell per bucket of the given granularity in the range.
+  std::vector<std::pair<int, RollupCell>> series(Granularity g, int fromDay, int toDay,
+                                                 const std::string& techId = {}) const;
+
+  const std::map<Key, RollupCell>& days() const { return tables_[0]; }
+  bool empty() const { return tables_[0].empty(); }
+
+  // Calendar helpers; days count from 1970-01-01 in local time, weeks start on Monday.
+  static int dayOf(std::int64_t epochMs);
+  static int dayFromDate(int year, int month, int day);
+  static int weekOf(int day);
+  static int monthOf(int day);     // year * 12 + (month - 1)
+  static int firstDayOfWeek(int week);
+  static int firstDayOfMonth(int month);
+
+private:
+  std::map<Key, RollupCell> tables_[3]; // indexed by Granularity
+
+  using Visitor = std::function<void(const std::string& techId, const RollupCell&)>;
+
+  void addCell(const Key& dayKey, const RollupCell& cell);
+  void accumulate(Granularity g, int bucket, const std::string& techId, const std::string& serviceId,
+                  const Visitor& fn) const;
+  // Covers [fromDay, toDay] with as few month/week/day cells as possible.
+  void visitRange(int fromDay, int toDay, const std::string& techId, const std::string& serviceId,
+                  const Visitor& fn) const;
+};
@@ -0,0 +1,285 @@
+#include "server/api_router.hpp"
+#include "metrics/metrics_registry.hpp"
+#include "persistence/work_order_json.hpp"
+#include "trace/tracer.hpp"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+// Thrown for malformed requests, as opposed to operations the domain rejects
+struct BadRequest : std::runtime_error {
+  using std::runtime_error::runtime_error;
+};
+
+HttpResponse json(int status, const QJsonObject& body) {
+  HttpResponse r;
+  r.status = status;
+  r.body = QJsonDocument(body).toJson(QJsonDocument::Compact).toStdString();
+  return r;
+}
+
+HttpResponse error(int status, const std::string& message) {
+  return json(status, QJsonObject{{"error", QString::fromStdString(message)}});
+}
+
+QJsonObject parseBody(const HttpRequest& request) {
+  if (request.body.empty()) return {};
+  QJsonParseError parseError;
+  auto doc = QJsonDocument::fromJson(QByteArray(request.body.data(), static_cast<qsizetype>(request.body.size())), &parseError);
+  if (parseError.error != QJsonParseError::NoError || !doc.isObject()) throw BadRequest("body is not a JSON object");
+  return doc.object();
+}
+
+std::string field(const QJsonObject& body, const char* name) {
+  return body.value(name).toString().toStdString();
+}
+
+// The version the client last read, when it sent one
+std::optional<std::uint64_t> expectedVersion(const QJsonObject& body) {
+  if (!body.contains("version")) return std::nullopt;
+  return static_cast<std::uint64_t>(body.value("version").toInteger());
+}
+
+constexpr int kMaxAttempts = 3;
+
+// Runs `update` with the version the client sent. When the body also has
+// "retry": true, a conflict re-reads the version through `current` and runs
+// the update again, so a delivery or a status step is not lost to someone
+// else's edit in between.
+template <class Current, class Update>
+auto versioned(const QJsonObject& body, ConflictMetrics& metrics, Current&& current, Update&& update) {
+  auto version = expectedVersion(body);
+  if (!version || !body.value("retry").toBool()) return update(version);
+  bool reread = false;
+  return retryOnConflict([&] {
+    if (reread) version = current();
+    reread = true;
+    return update(version);
+  }, kMaxAttempts, &metrics);
+}
+
+QJsonObject countersToJson(const ConflictCounters& c) {
+  return QJsonObject{{"checks", static_cast<qint64>(c.checks.load())},
+                     {"conflicts", static_cast<qint64>(c.conflicts.load())},
+                     {"retries", static_cast<qint64>(c.retries.load())},
+                     {"exhausted", static_cast<qint64>(c.exhausted.load())}};
+}
+
+std::vector<std::string> splitPath(const std::string& path) {
+  std::vector<std::string> segments;
+  std::size_t begin = 0;
+  while (begin < path.size()) {
+    auto end = path.find('/', begin);
+    if (end == std::string::npos) end = path.size();
+    if (end > begin) segments.push_back(path.substr(begin, end - begin));
+    begin = end + 1;
+  }
+  return segments;
+}
+
+std::size_t number(const HttpRequest& request, const std::string& key, std::size_t fallback) {
+  auto text = request.param(key);
+  if (text.empty()) return fallback;
+  try {
+    return static_cast<std::size_t>(std::stoul(text));
+  } catch (const std::exception&) {
+    throw BadRequest(key + " must be a number");
+  }
+}
+
+// One page of `items`, serialized with `toJson`
+template <class T, class ToJson>
+QJsonObject page(const HttpRequest& request, const std::vector<T>& items, ToJson toJson) {
+  const auto offset = std::min(number(request, "offset", 0), items.size());
+  const auto limit = number(request, "limit", 100);
+  const auto end = offset + std::min(limit, items.size() - offset);
+  QJsonArray out;
+  for (auto i = offset; i < end; ++i) out.push_back(toJson(items[i]));
+  return QJsonObject{{"total", static_cast<qint64>(items.size())}, {"offset", static_cast<qint64>(offset)},
+                     {"items", out}};
+}
+
+QJsonObject orderSummary(const WorkOrder& w) {
+  return QJsonObject{{"id", QString::fromStdString(w.id)}, {"vin", QString::fromStdString(w.vehicle.vin)},
+                     {"plate", QString::fromStdString(w.vehicle.plate)},
+                     {"customer", QString::fromStdString(w.customer.name)},
+                     {"technician", QString::fromStdString(w.tech.id)},
+                     {"status", statusToString(w.status)},
+                     {"total", w.previewTotal()}, {"version", static_cast<qint64>(w.version)}};
+}
+}
+
+ApiRouter::ApiRouter(DataStore& store, StoreHouse& storeHouse, WorkshopService& service, ChangeBus& bus)
+    : store_(store), storeHouse_(storeHouse), service_(service), bus_(bus) {
+  for (const auto& v : store_.vehicles) search_.addVehicle(v);
+  for (const auto& c : store_.customers) search_.addCustomer(c);
+  for (const auto& p : store_.parts) search_.addPart(p);
+  bus_.addObserver(this);
+}
+
+ApiRouter::~ApiRouter() {
+  bus_.removeObserver(this);
+}
+
+void ApiRouter::onChange(const ChangeEvent& event) {
+  dirty_ = true;
+  if (event.change != Change::Added) return;
+  if (event.entity == Entity::Customer) search_.addCustomer(store_.customers[event.row]);
+  else if (event.entity == Entity::Vehicle) search_.addVehicle(store_.vehicles[event.row]);
+}
+
+HttpResponse ApiRouter::handle(const HttpRequest& request) {
+  TRACE_SCOPE("api.handle");
+  try {
+    return route(request, splitPath(request.path));
+  } catch (const BadRequest& e) {
+    return error(400, e.what());
+  } catch (const VersionConflict& e) {
+    // The client re-reads and retries with the current version
+    return json(409, QJsonObject{{"error", e.what()}, {"currentVersion", static_cast<qint64>(e.actual)}});
+  } catch (const std::exception& e) {
+    // The domain rejected the operation (wrong state, duplicate id, ...)
+    return error(409, e.what());
+  }
+}
+
+HttpResponse ApiRouter::route(const HttpRequest& request, const std::vector<std::string>& segments) {
+  const bool get = request.method == "GET";
+  const bool post = request.method == "POST";
+  if (!get && !post) return error(405, "only GET and POST are supported");
+  if (segments.empty()) return error(404, "no such resource");
+  const auto& resource = segments[0];
+
+  if (resource == "metrics" && segments.size() == 1 && get) {
+    HttpResponse r;
+    std::ostringstream out;
+    MetricsRegistry::global().writePrometheus(out);
+    r.body = out.str();
+    r.contentType = "text/plain; version=0.0.4";
+    return r;
+  }
+  if (resource == "debug" && segments.size() == 2 && segments[1] == "trace" && get) {
+    HttpResponse r;
+    std::ostringstream out;
+    Tracer::writeJson(out);
+    r.body = out.str();
+    return r;
+  }
+  if (resource == "health" && get) {
+    return json(200, QJsonObject{{"status", "ok"}, {"workOrders", static_cast<qint64>(store_.workOrders.size())}});
+  }
+  if (resource == "customers" && segments.size() == 1) {
+    if (get) return json(200, page(request, store_.customers, customerToJson));
+    auto c = customerFromJson(parseBody(request));
+    return json(201, customerToJson(service_.addCustomer(c)));
+  }
+  if (resource == "vehicles" && segments.size() == 1) {
+    if (post) {
+      auto v = vehicleFromJson(parseBody(request));
+      service_.addVehicle(v);
+      return json(201, vehicleToJson(v));
+    }
+    const auto owner = request.param("owner");
+    if (owner.empty()) return json(200, page(request, store_.vehicles, vehicleToJson));
+    std::vector<Vehicle> owned;
+    std::copy_if(store_.vehicles.begin(), store_.vehicles.end(), std::back_inserter(owned),
+                 [&](const Vehicle& v){ return v.ownerId == owner; });
+    return json(200, page(request, owned, vehicleToJson));
+  }
+  if (resource == "technicians" && segments.size() == 1) {
+    if (get) return json(200, page(request, store_.technicians, technicianToJson));
+    auto t = technicianFromJson(parseBody(request));
+    t.assignedWorkOrders.clear(); // assignments come from work orders only
+    service_.addTechnician(t);
+    return json(201, technicianToJson(t));
+  }
+  if (resource == "workorders") {
+    if (segments.size() == 1 && get) return json(200, page(request, store_.workOrders, orderSummary));
+    if (segments.size() == 1) {
+      auto body = parseBody(request);
+      auto row = service_.createOrder(field(body, "vin"), field(body, "techId"), body.value("mileage").toInt());
+      return json(201, workOrderToJson(store_.workOrders[row]));
+    }
+    if (segments.size() == 2 && get) {
+      auto row = service_.findOrder(segments[1]);
+      if (!row) return error(404, "no work order for " + segments[1]);
+      return json(200, workOrderToJson(store_.workOrders[*row]));
+    }
+    if (segments.size() == 3 && post) return workOrderAction(request, segments[1], segments[2]);
+  }
+  if (resource == "inventory") {
+    if (segments.size() == 1 && get) return json(200, page(request, storeHouse_.snapshot(), stockedPartToJson));
+    if (segments.size() == 3 && post) {
+      const auto& partId = segments[1];
+      const auto& action = segments[2];
+      auto body = parseBody(request);
+      auto current = [&] {
+        auto part = storeHouse_.find(partId);
+        return part ? part->version : 0;
+      };
+      auto& metrics = service_.conflictMetrics();
+      bool found = false;
+      if (action == "receive") {
+        found = versioned(body, metrics, current, [&](std::optional<std::uint64_t> version) {
+          return service_.receiveStock(partId, body.value("qty").toInt(), version);
+        });
+      } else if (action == "stock") {
+        found = versioned(body, metrics, current, [&](std::optional<std::uint64_t> version) {
+          return service_.setStock(partId, body.value("stock").toInt(), version);
+        });
+      } else if (action == "adjust") {
+        found = service_.adjustStock(partId, body.value("delta").toInt());
+      } else {
+        return error(404, "no such action " + action);
+      }
+      if (!found) return error(404, "no part " + partId);
+      dirty_ = true;
+      return json(200, stockedPartToJson(*storeHouse_.find(partId)));
+    }
+  }
+  if (resource == "metrics" && segments.size() == 2 && segments[1] == "conflicts" && get) {
+    const auto& metrics = service_.conflictMetrics();
+    return json(200, QJsonObject{{"workOrders", countersToJson(metrics.of(Versioned::WorkOrder))},
+                                 {"parts", countersToJson(metrics.of(Versioned::Part))}});
+  }
+  if (resource == "search" && get) {
+    QJsonArray hits;
+    for (const auto& hit : search_.search(request.param("q"), number(request, "limit", 20))) {
+      const char* kind = hit.kind == SearchKind::Vehicle ? "vehicle" : hit.kind == SearchKind::Customer ? "customer" : "part";
+      hits.push_back(QJsonObject{{"kind", kind}, {"id", QString::fromStdString(hit.id)},
+                                 {"label", QString::fromStdString(hit.label)}});
+    }
+    return json(200, QJsonObject{{"items", hits}});
+  }
+  return error(404, "no such resource");
+}
+
+HttpResponse ApiRouter::workOrderAction(const HttpRequest& request, const std::string& ref, const std::string& action) {
+  auto row = service_.findOrder(ref);
+  if (!row) return error(404, "no work order for " + ref);
+  const auto body = parseBody(request);
+  auto current = [&] { return store_.workOrders[*row].version; };
+  auto& metrics = service_.conflictMetrics();
+  using Version = std::optional<std::uint64_t>;
+  if (action == "assign") {
+    versioned(body, metrics, current, [&](Version v) { service_.assign(*row, field(body, "techId"), v); });
+  } else if (action == "start") {
+    versioned(body, metrics, current, [&](Version v) { service_.start(*row, v); });
+  } else if (action == "complete") {
+    versioned(body, metrics, current, [&](Version v) { service_.complete(*row, v); });
+  } else if (action == "settle") {
+    auto result = versioned(body, metrics, current, [&](Version v) { return service_.settle(*row, v); });
+    QJsonArray alerts;
+    for (const auto& a : result.alerts) alerts.push_back(QString::fromStdString(a));
+    return json(200, QJsonObject{{"total", result.total}, {"partsConsumed", result.partsConsumed},
+                                 {"alerts", alerts}, {"order", orderSummary(store_.workOrders[*row])}});
+  } else {
+    return error(404, "no such action " + action);
+  }
+  return json(200, orderSummary(store_.workOrders[*row]));
+}
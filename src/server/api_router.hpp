@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "domain/change_bus.hpp"
+#include "domain/data_store.hpp"
+#include "domain/search_index.hpp"
+#include "inventory/store_house.hpp"
+#include "server/http_message.hpp"
+#include "service/workshop_service.hpp"
+
+// Maps the JSON API onto WorkshopService. Not thread-safe: the server calls
+// handle() from its event loop only, which is what serializes access to the
+// store.
+//
+//   GET  /health
+//   GET  /customers            POST /customers     {name, phone, level[, id]}
+//   GET  /vehicles[?owner=]    POST /vehicles      {vin, plate, brand, model, year, ownerId, mileage}
+//   GET  /technicians          POST /technicians   {id, name, hourlyRate}
+//   GET  /workorders           POST /workorders    {vin, techId[, mileage]}
+//   GET  /workorders/<id|vin>
+//   POST /workorders/<id|vin>/assign {techId} | /start | /complete | /settle
+//   GET  /inventory            POST /inventory/<partId>/receive {qty}
+//                              POST /inventory/<partId>/stock {stock}
+//                              POST /inventory/<partId>/adjust {delta}
+//   GET  /search?q=
+//   GET  /metrics/conflicts
+// Lists take ?offset= and ?limit= (default 100). Errors come back as
+// {"error": "..."} with a 4xx status. Order and part updates accept the
+// "version" the client last read; a stale one gets 409 with
+// "currentVersion", unless the body also has "retry": true, in which case
+// the update is re-applied at the current version (up to three attempts).
+class ApiRouter : public ChangeObserver {
+public:
+  ApiRouter(DataStore& store, StoreHouse& storeHouse, WorkshopService& service, ChangeBus& bus);
+  ~ApiRouter() override;
+
+  HttpResponse handle(const HttpRequest& request);
+  // True once a request changed the store; cleared by the caller after saving.
+  bool dirty() const { return dirty_; }
+  void clearDirty() { dirty_ = false; }
+
+  void onChange(const ChangeEvent& event) override;
+
+private:
+  DataStore& store_;
+  StoreHouse& storeHouse_;
+  WorkshopService& service_;
+  ChangeBus& bus_;
+  SearchIndex search_;
+  bool dirty_{false};
+
+  HttpResponse route(const HttpRequest& request, const std::vector<std::string>& segments);
+  HttpResponse workOrderAction(const HttpRequest& request, const std::string& ref, const std::string& action);
+};
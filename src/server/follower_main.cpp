@@ -0,0 +1,54 @@
+// Read-only reporting node: follows the primary's change log and answers
+// report queries from its own copy of the store.
+#include <QCoreApplication>
+#include <QTimer>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "metrics/metrics_file_writer.hpp"
+#include "persistence/change_log.hpp"
+#include "server/http_server.hpp"
+#include "server/report_router.hpp"
+#include "server/termination_signal.hpp"
+#include "trace/tracer.hpp"
+
+int main(int argc, char* argv[]) {
+  Tracer::installFromEnvironment();
+  MetricsFileWriter::installFromEnvironment();
+  Tracer::setThreadName("follower");
+  QCoreApplication app(argc, argv);
+  std::string dataPath = "data/data_store.json";
+  int port = 8081;
+  int pollMs = 10;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--data") == 0 && i + 1 < argc) dataPath = argv[++i];
+    else if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc) port = std::atoi(argv[++i]);
+    else if (std::strcmp(argv[i], "--poll") == 0 && i + 1 < argc) pollMs = std::atoi(argv[++i]);
+    else {
+      std::cerr << "usage: auto_repair_follower [--port 8081] [--data data_store.json] [--poll ms]" << std::endl;
+      return 2;
+    }
+  }
+
+  ChangeLogFollower follower(dataPath, ChangeLogWriter::pathFor(dataPath));
+  follower.bootstrap();
+  follower.poll();
+
+  QTimer pollTimer;
+  pollTimer.setInterval(pollMs);
+  QObject::connect(&pollTimer, &QTimer::timeout, [&follower] { follower.poll(); });
+  pollTimer.start();
+
+  ReportRouter router(follower);
+  HttpServer server([&router](const HttpRequest& request) { return router.handle(request); });
+  if (!server.listen(static_cast<quint16>(port))) {
+    std::cerr << "cannot listen on 127.0.0.1:" << port << std::endl;
+    return 1;
+  }
+  std::cout << "following " << ChangeLogWriter::pathFor(dataPath) << ", reports on http://127.0.0.1:"
+            << server.port() << std::endl;
+  // Ctrl-C leaves through the event loop
+  TerminationSignal termination;
+  return app.exec();
+}
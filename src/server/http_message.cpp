@@ -0,0 +1,132 @@
+#include "server/http_message.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+namespace {
+const char* reasonPhrase(int status) {
+  switch (status) {
+    case 200: return "OK";
+    case 201: return "Created";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 409: return "Conflict";
+    default: return "Internal Server Error";
+  }
+}
+
+std::string lower(std::string text) {
+  std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c){ return static_cast<char>(std::tolower(c)); });
+  return text;
+}
+
+std::string trim(const std::string& text) {
+  auto first = text.find_first_not_of(" \t");
+  if (first == std::string::npos) return {};
+  auto last = text.find_last_not_of(" \t");
+  return text.substr(first, last - first + 1);
+}
+
+void parseQuery(const std::string& text, std::map<std::string, std::string>& out) {
+  std::size_t begin = 0;
+  while (begin < text.size()) {
+    auto end = text.find('&', begin);
+    if (end == std::string::npos) end = text.size();
+    auto pair = text.substr(begin, end - begin);
+    auto eq = pair.find('=');
+    if (!pair.empty()) {
+      out[HttpRequestParser::urlDecode(pair.substr(0, eq))] =
+          eq == std::string::npos ? std::string() : HttpRequestParser::urlDecode(pair.substr(eq + 1));
+    }
+    begin = end + 1;
+  }
+}
+}
+
+std::string HttpResponse::serialize(bool keepAlive) const {
+  std::string out;
+  out.reserve(body.size() + 128);
+  out += "HTTP/1.1 ";
+  out += std::to_string(status);
+  out += ' ';
+  out += reasonPhrase(status);
+  out += "\r\nContent-Type: ";
+  out += contentType;
+  out += "\r\nContent-Length: ";
+  out += std::to_string(body.size());
+  out += keepAlive ? "\r\nConnection: keep-alive\r\n\r\n" : "\r\nConnection: close\r\n\r\n";
+  out += body;
+  return out;
+}
+
+std::string HttpRequestParser::urlDecode(const std::string& text) {
+  std::string out;
+  out.reserve(text.size());
+  for (std::size_t i = 0; i < text.size(); ++i) {
+    if (text[i] == '+') {
+      out += ' ';
+    } else if (text[i] == '%' && i + 2 < text.size() && std::isxdigit(static_cast<unsigned char>(text[i + 1]))
+               && std::isxdigit(static_cast<unsigned char>(text[i + 2]))) {
+      out += static_cast<char>(std::strtol(text.substr(i + 1, 2).c_str(), nullptr, 16));
+      i += 2;
+    } else {
+      out += text[i];
+    }
+  }
+  return out;
+}
+
+HttpRequestParser::State HttpRequestParser::next(HttpRequest& out) {
+  auto headerEnd = buffer_.find("\r\n\r\n");
+  if (headerEnd == std::string::npos) {
+    return buffer_.size() > kMaxHeaderBytes ? State::Bad : State::NeedMore;
+  }
+
+  HttpRequest request;
+  auto lineEnd = buffer_.find("\r\n");
+  const auto requestLine = buffer_.substr(0, lineEnd);
+  auto sp1 = requestLine.find(' ');
+  auto sp2 = requestLine.rfind(' ');
+  if (sp1 == std::string::npos || sp2 == sp1) return State::Bad;
+  request.method = requestLine.substr(0, sp1);
+  auto target = requestLine.substr(sp1 + 1, sp2 - sp1 - 1);
+  const auto version = requestLine.substr(sp2 + 1);
+  if (version.compare(0, 5, "HTTP/") != 0) return State::Bad;
+  request.keepAlive = version != "HTTP/1.0";
+
+  auto qmark = target.find('?');
+  request.path = urlDecode(target.substr(0, qmark));
+  if (qmark != std::string::npos) parseQuery(target.substr(qmark + 1), request.query);
+
+  std::size_t contentLength = 0;
+  std::size_t pos = lineEnd + 2;
+  while (pos < headerEnd) {
+    auto end = buffer_.find("\r\n", pos);
+    auto colon = buffer_.find(':', pos);
+    if (colon == std::string::npos || colon > end) return State::Bad;
+    const auto name = lower(buffer_.substr(pos, colon - pos));
+    const auto value = trim(buffer_.substr(colon + 1, end - colon - 1));
+    if (name == "content-length") {
+      char* stop = nullptr;
+      contentLength = std::strtoul(value.c_str(), &stop, 10);
+      if (value.empty() || *stop != '\0') return State::Bad;
+    } else if (name == "transfer-encoding") {
+      return State::Bad;
+    } else if (name == "connection") {
+      const auto v = lower(value);
+      if (v == "close") request.keepAlive = false;
+      else if (v == "keep-alive") request.keepAlive = true;
+    }
+    pos = end + 2;
+  }
+  if (contentLength > kMaxBodyBytes) return State::Bad;
+
+  const auto bodyStart = headerEnd + 4;
+  if (buffer_.size() < bodyStart + contentLength) return State::NeedMore;
+  request.body = buffer_.substr(bodyStart, contentLength);
+  buffer_.erase(0, bodyStart + contentLength);
+  out = std::move(request);
+  return State::Ready;
+}
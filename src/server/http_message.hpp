@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+struct HttpRequest {
+  std::string method;
+  std::string path;                          // without the query string
+  std::map<std::string, std::string> query;  // decoded
+  std::string body;
+  bool keepAlive{true};
+
+  std::string param(const std::string& key, const std::string& fallback = {}) const {
+    auto it = query.find(key);
+    return it == query.end() ? fallback : it->second;
+  }
+};
+
+struct HttpResponse {
+  int status{200};
+  std::string body;
+  std::string contentType{"application/json"};
+
+  // Status line, headers and body, ready for the socket.
+  std::string serialize(bool keepAlive) const;
+};
+
+// Incremental HTTP/1.x request parser for one connection. Bytes are appended
+// as they arrive; next() extracts one complete request at a time, so
+// pipelined requests come out in order. Only Content-Length bodies are
+// accepted.
+class HttpRequestParser {
+public:
+  enum class State { NeedMore, Ready, Bad };
+
+  static constexpr std::size_t kMaxHeaderBytes = 16 * 1024;
+  static constexpr std::size_t kMaxBodyBytes = 1024 * 1024;
+
+  void append(const char* data, std::size_t size) { buffer_.append(data, size); }
+  State next(HttpRequest& out);
+
+  static std::string urlDecode(const std::string& text);
+
+private:
+  std::string buffer_;
+};
@@ -0,0 +1,55 @@
+#include "server/http_server.hpp"
+
+#include <QHostAddress>
+
+HttpServer::HttpServer(Handler handler, QObject* parent) : QObject(parent), handler_(std::move(handler)) {
+  connect(&server_, &QTcpServer::newConnection, this, [this] { acceptConnections(); });
+}
+
+bool HttpServer::listen(quint16 port) {
+  return server_.listen(QHostAddress::LocalHost, port);
+}
+
+void HttpServer::acceptConnections() {
+  while (auto* socket = server_.nextPendingConnection()) {
+    socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    parsers_.emplace(socket, HttpRequestParser{});
+    connect(socket, &QTcpSocket::readyRead, this, [this, socket] { readClient(socket); });
+    connect(socket, &QTcpSocket::disconnected, this, [this, socket] {
+      parsers_.erase(socket);
+      socket->deleteLater();
+    });
+  }
+}
+
+void HttpServer::readClient(QTcpSocket* socket) {
+  auto it = parsers_.find(socket);
+  if (it == parsers_.end()) return;
+  auto& parser = it->second;
+  const auto bytes = socket->readAll();
+  parser.append(bytes.constData(), static_cast<std::size_t>(bytes.size()));
+
+  // Answer every complete request in the buffer with a single write
+  std::string out;
+  bool close = false;
+  HttpRequest request;
+  for (;;) {
+    auto state = parser.next(request);
+    if (state == HttpRequestParser::State::NeedMore) break;
+    if (state == HttpRequestParser::State::Bad) {
+      HttpResponse bad;
+      bad.status = 400;
+      bad.body = R"({"error":"malformed request"})";
+      out += bad.serialize(false);
+      close = true;
+      break;
+    }
+    out += handler_(request).serialize(request.keepAlive);
+    if (!request.keepAlive) {
+      close = true;
+      break;
+    }
+  }
+  if (!out.empty()) socket->write(out.data(), static_cast<qint64>(out.size()));
+  if (close) socket->disconnectFromHost();
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <functional>
+#include <unordered_map>
+#include "server/http_message.hpp"
+
+// Serves a request handler over HTTP/1.1 on localhost. Every socket is
+// handled on the thread running the Qt event loop, so the handler sees one
+// request at a time and needs no locks; keep-alive and pipelined requests
+// avoid a handshake per call.
+class HttpServer : public QObject {
+public:
+  using Handler = std::function<HttpResponse(const HttpRequest&)>;
+
+  explicit HttpServer(Handler handler, QObject* parent = nullptr);
+
+  bool listen(quint16 port);
+  quint16 port() const { return server_.serverPort(); }
+
+private:
+  Handler handler_;
+  QTcpServer server_;
+  std::unordered_map<QTcpSocket*, HttpRequestParser> parsers_;
+
+  void acceptConnections();
+  void readClient(QTcpSocket* socket);
+};
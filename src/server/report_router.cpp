@@ -0,0 +1,107 @@
+#include "server/report_router.hpp"
+#include "metrics/metrics_registry.hpp"
+#include "persistence/work_order_json.hpp"
+#include "report/report_service.hpp"
+#include "trace/tracer.hpp"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+namespace {
+HttpResponse json(int status, const QJsonObject& body) {
+  HttpResponse r;
+  r.status = status;
+  r.body = QJsonDocument(body).toJson(QJsonDocument::Compact).toStdString();
+  return r;
+}
+
+HttpResponse error(int status, const std::string& message) {
+  return json(status, QJsonObject{{"error", QString::fromStdString(message)}});
+}
+
+bool parseDay(const std::string& text, int& day) {
+  int y = 0, m = 0, d = 0;
+  if (std::sscanf(text.c_str(), "%d-%d-%d", &y, &m, &d) != 3) return false;
+  day = TurnoverRollup::dayFromDate(y, m, d);
+  return true;
+}
+
+QJsonArray ranked(const std::vector<RankedEntry>& list) {
+  QJsonArray out;
+  for (const auto& e : list) out.push_back(QJsonObject{{"id", QString::fromStdString(e.key)}, {"value", e.value}});
+  return out;
+}
+
+QJsonObject histogram(const LatencyHistogram& h) {
+  return QJsonObject{{"count", static_cast<qint64>(h.count())}, {"p50", static_cast<qint64>(h.percentile(0.5))},
+                     {"p90", static_cast<qint64>(h.percentile(0.9))}, {"p99", static_cast<qint64>(h.percentile(0.99))},
+                     {"max", static_cast<qint64>(h.max())}};
+}
+}
+
+HttpResponse ReportRouter::handle(const HttpRequest& request) const {
+  if (request.method != "GET") return error(405, "the follower is read-only");
+  TRACE_SCOPE("reports.handle");
+  const auto& store = follower_.store();
+
+  if (request.path == "/metrics") {
+    HttpResponse r;
+    std::ostringstream out;
+    MetricsRegistry::global().writePrometheus(out);
+    r.body = out.str();
+    r.contentType = "text/plain; version=0.0.4";
+    return r;
+  }
+  if (request.path == "/debug/trace") {
+    HttpResponse r;
+    std::ostringstream out;
+    Tracer::writeJson(out);
+    r.body = out.str();
+    return r;
+  }
+
+  if (request.path == "/reports/summary") {
+    // Counts only, so no order id is copied per request
+    const auto totals = ReportEngine::totals(store.orderColumns);
+    QJsonObject counts;
+    for (std::size_t s = 0; s < totals.statusCounts.size(); ++s) {
+      if (totals.statusCounts[s] > 0) counts.insert(statusToString(static_cast<WOStatus>(s)), totals.statusCounts[s]);
+    }
+    return json(200, QJsonObject{{"turnover", static_cast<double>(totals.turnoverCents) / 100},
+                                 {"paidCount", totals.paidCount}, {"statusCounts", counts}});
+  }
+  if (request.path == "/reports/turnover") {
+    int from = 0, to = 0;
+    if (!parseDay(request.param("from"), from) || !parseDay(request.param("to"), to)) {
+      return error(400, "from and to must be yyyy-mm-dd");
+    }
+    auto report = ReportService::turnover(store.turnoverRollup, from, to, request.param("tech"));
+    return json(200, QJsonObject{{"turnover", report.total}, {"orders", report.count}});
+  }
+  if (request.path == "/reports/top") {
+    const auto k = static_cast<std::size_t>(std::max(1, std::atoi(request.param("k", "10").c_str())));
+    return json(200, QJsonObject{{"parts", ranked(ReportService::topParts(store.topN, k))},
+                                 {"customers", ranked(ReportService::topCustomers(store.topN, k))},
+                                 {"technicians", ranked(ReportService::topTechnicians(store.topN, k))}});
+  }
+  if (request.path == "/reports/latency") {
+    QJsonObject stages;
+    for (auto stage : kStages) stages.insert(stageName(stage), histogram(store.lifecycleStats.overall(stage)));
+    return json(200, stages);
+  }
+  if (request.path == "/replication") {
+    const auto& stats = follower_.stats();
+    return json(200, QJsonObject{{"appliedSeq", static_cast<qint64>(stats.appliedSeq)},
+                                 {"records", static_cast<qint64>(stats.records)},
+                                 {"reloads", static_cast<qint64>(stats.reloads)},
+                                 {"pendingBytes", static_cast<qint64>(follower_.pendingBytes())},
+                                 {"lastLagUs", static_cast<qint64>(stats.lastLagUs)},
+                                 {"lagUs", histogram(stats.lagUs)}});
+  }
+  return error(404, "no such report");
+}
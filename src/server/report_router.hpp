@@ -0,0 +1,22 @@
+#pragma once
+
+#include "persistence/change_log.hpp"
+#include "server/http_message.hpp"
+
+// Read-only report queries answered from a follower's replicated store, so
+// month-end reporting never touches the shop-floor process.
+//
+//   GET /reports/summary
+//   GET /reports/turnover?from=yyyy-mm-dd&to=yyyy-mm-dd[&tech=]
+//   GET /reports/top[?k=10]
+//   GET /reports/latency
+//   GET /replication
+class ReportRouter {
+public:
+  explicit ReportRouter(const ChangeLogFollower& follower) : follower_(follower) {}
+
+  HttpResponse handle(const HttpRequest& request) const;
+
+private:
+  const ChangeLogFollower& follower_;
+};
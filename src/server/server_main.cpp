@@ -0,0 +1,87 @@
+// Localhost JSON API over the workshop core, so the front desk, bays and
+// parts counter can share one store from separate terminals.
+#include <QCoreApplication>
+#include <QTimer>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "domain/change_bus.hpp"
+#include "inventory/store_house.hpp"
+#include "metrics/metrics_file_writer.hpp"
+#include "persistence/change_log.hpp"
+#include "persistence/data_store_persistence.hpp"
+#include "persistence/store_bootstrap.hpp"
+#include "persistence/work_order_archive.hpp"
+#include "server/api_router.hpp"
+#include "server/http_server.hpp"
+#include "server/termination_signal.hpp"
+#include "service/workshop_service.hpp"
+#include "trace/tracer.hpp"
+
+int main(int argc, char* argv[]) {
+  Tracer::installFromEnvironment();
+  MetricsFileWriter::installFromEnvironment();
+  Tracer::setThreadName("server");
+  QCoreApplication app(argc, argv);
+  std::string dataPath = "data/data_store.json";
+  int port = 8080;
+  int saveIntervalMs = 1000;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--data") == 0 && i + 1 < argc) dataPath = argv[++i];
+    else if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc) port = std::atoi(argv[++i]);
+    else if (std::strcmp(argv[i], "--save-interval") == 0 && i + 1 < argc) saveIntervalMs = std::atoi(argv[++i]);
+    else {
+      std::cerr << "usage: auto_repair_server [--port 8080] [--data data_store.json] [--save-interval ms]" << std::endl;
+      return 2;
+    }
+  }
+
+  DataStore store = StoreBootstrap::loadOrSeed(dataPath);
+  WorkOrderArchive archive(WorkOrderArchive::directoryFor(dataPath));
+  StoreBootstrap::archiveAged(store, archive, dataPath);
+  StoreHouse storeHouse(store.parts);
+  ChangeBus bus;
+  WorkshopService service(store, storeHouse, archive.archivedCount());
+  service.setChangeBus(&bus);
+  ApiRouter router(store, storeHouse, service, bus);
+  // Followers reload the saved store, then replay this log
+  ChangeLogWriter changeLog(store, ChangeLogWriter::pathFor(dataPath));
+  changeLog.restart();
+  bus.addObserver(&changeLog);
+
+  // Saved at most once per interval rather than per request
+  auto saveIfDirty = [&] {
+    if (!router.dirty()) return;
+    DataStorePersistence::save(store, dataPath);
+    router.clearDirty();
+  };
+  QTimer saveTimer;
+  saveTimer.setInterval(saveIntervalMs);
+  QObject::connect(&saveTimer, &QTimer::timeout, saveIfDirty);
+  saveTimer.start();
+
+  // Orders that age while the server runs are archived hourly. The sweep
+  // saves the store, and restarting the log makes followers reload it.
+  QTimer archiveTimer;
+  archiveTimer.setInterval(60 * 60 * 1000);
+  QObject::connect(&archiveTimer, &QTimer::timeout, [&] {
+    if (StoreBootstrap::archiveAged(store, archive, dataPath) == 0) return;
+    service.setArchivedOrders(archive.archivedCount());
+    service.reindex();
+    router.clearDirty();
+    changeLog.restart();
+  });
+  archiveTimer.start();
+
+  HttpServer server([&router](const HttpRequest& request) { return router.handle(request); });
+  if (!server.listen(static_cast<quint16>(port))) {
+    std::cerr << "cannot listen on 127.0.0.1:" << port << std::endl;
+    return 1;
+  }
+  std::cout << "listening on http://127.0.0.1:" << server.port() << std::endl;
+  // Ctrl-C leaves through the event loop so pending changes get saved
+  TerminationSignal termination;
+  QObject::connect(&app, &QCoreApplication::aboutToQuit, saveIfDirty);
+  return app.exec();
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <QCoreApplication>
+#include <QTimer>
+#include <csignal>
+
+// Quits the event loop on SIGINT or SIGTERM. The handler only sets a flag,
+// the one thing a signal handler may safely do; a timer on the event loop
+// polls it and calls quit(), so aboutToQuit handlers still run.
+class TerminationSignal {
+public:
+  explicit TerminationSignal(int pollMs = 100) {
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    QObject::connect(&timer_, &QTimer::timeout, [] {
+      if (received_) QCoreApplication::quit();
+    });
+    timer_.start(pollMs);
+  }
+
+private:
+  static void onSignal(int) { received_ = 1; }
+
+  static inline volatile std::sig_atomic_t received_ = 0;
+  QTimer timer_;
+};
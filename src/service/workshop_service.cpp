@@ -0,0 +1,308 @@
+#include "service/workshop_service.hpp"
+#include "domain/maintenance_detector.hpp"
+#include "metrics/metrics_registry.hpp"
+#include "persistence/data_store_persistence.hpp"
+#include "trace/tracer.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace {
+std::string generateId(const std::string& prefix, int number) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%s%04d", prefix.c_str(), number);
+  return std::string(buf);
+}
+
+// Counts a work order entering `status`
+void countTransition(WOStatus status) {
+  static const auto counters = [] {
+    std::vector<Counter*> byStatus; // in WOStatus order
+    for (const char* to : {"Draft", "Assigned", "InProgress", "Completed", "Paid", "Cancelled"}) {
+      byStatus.push_back(&MetricsRegistry::global().counter("auto_repair_work_order_transitions_total",
+                                                            "Work orders entering each status", {{"to", to}}));
+    }
+    return byStatus;
+  }();
+  counters[static_cast<int>(status)]->inc();
+}
+}
+
+WorkshopService::WorkshopService(DataStore& store, StoreHouse& storeHouse, int archivedOrders)
+    : store_(store), storeHouse_(storeHouse), archivedOrders_(archivedOrders) {
+  reindex();
+}
+
+void WorkshopService::reindex() {
+  vehicleByVin_.clear();
+  technicianById_.clear();
+  customerById_.clear();
+  orderById_.clear();
+  orderByVin_.clear();
+  for (std::size_t i = 0; i < store_.vehicles.size(); ++i) vehicleByVin_.emplace(store_.vehicles[i].vin, i);
+  for (std::size_t i = 0; i < store_.technicians.size(); ++i) technicianById_.emplace(store_.technicians[i].id, i);
+  for (std::size_t i = 0; i < store_.customers.size(); ++i) customerById_.emplace(store_.customers[i].id, i);
+  indexParts();
+  for (std::size_t i = 0; i < store_.workOrders.size(); ++i) {
+    orderById_.emplace(store_.workOrders[i].id, i);
+    if (!isClosed(store_.workOrders[i].status)) orderByVin_.emplace(store_.workOrders[i].vehicle.vin, i);
+  }
+}
+
+const Customer& WorkshopService::addCustomer(Customer c) {
+  if (c.name.empty()) throw std::runtime_error("Customer name is required");
+  if (c.id.empty()) c.id = generateId("C", static_cast<int>(store_.customers.size() + 1));
+  if (customerById_.count(c.id)) throw std::runtime_error("Customer " + c.id + " already exists");
+  customerById_.emplace(c.id, store_.customers.size());
+  store_.customers.push_back(std::move(c));
+  publish(Entity::Customer, Change::Added, store_.customers.size() - 1);
+  return store_.customers.back();
+}
+
+void WorkshopService::addVehicle(const Vehicle& v) {
+  if (v.vin.empty() || v.plate.empty()) throw std::runtime_error("VIN and Plate are required");
+  if (vehicleByVin_.count(v.vin)) throw std::runtime_error("Vehicle " + v.vin + " already exists");
+  vehicleByVin_.emplace(v.vin, store_.vehicles.size());
+  store_.vehicles.push_back(v);
+  publish(Entity::Vehicle, Change::Added, store_.vehicles.size() - 1);
+}
+
+void WorkshopService::addTechnician(const Technician& t) {
+  if (t.id.empty() || t.name.empty()) throw std::runtime_error("ID and Name required");
+  if (technicianById_.count(t.id)) throw std::runtime_error("Mechanic " + t.id + " already exists");
+  technicianById_.emplace(t.id, store_.technicians.size());
+  store_.technicians.push_back(t);
+  publish(Entity::Technician, Change::Added, store_.technicians.size() - 1);
+}
+
+void WorkshopService::setHoursWorked(const std::string& techId, double hours) {
+  auto it = technicianById_.find(techId);
+  if (it == technicianById_.end()) throw std::runtime_error("Unknown mechanic " + techId);
+  auto& t = store_.technicians[it->second];
+  if (t.hoursWorked == hours) return;
+  t.hoursWorked = hours;
+  publish(Entity::Technician, Change::Updated, it->second);
+}
+
+std::size_t WorkshopService::createOrder(const std::string& vin, const std::string& techId, int mileage,
+                                         const std::vector<WOItem>& extraItems) {
+  TRACE_SCOPE("service.createOrder");
+  auto vehicleIt = vehicleByVin_.find(vin);
+  if (vehicleIt == vehicleByVin_.end()) throw std::runtime_error("Unknown vehicle " + vin);
+  if (vehicleHasOrder(vin)) throw std::runtime_error("This vehicle already has an open work order");
+  const auto& tech = technician(techId);
+  auto& vehicle = store_.vehicles[vehicleIt->second];
+  auto customerIt = customerById_.find(vehicle.ownerId);
+  if (customerIt == customerById_.end()) throw std::runtime_error("Vehicle owner not found");
+  if (mileage < 0 || (mileage > 0 && mileage < vehicle.mileage)) {
+    throw std::runtime_error("Mileage cannot be below the last reading of " + std::to_string(vehicle.mileage) + " km");
+  }
+  if (mileage > vehicle.mileage) {
+    vehicle.mileage = mileage;
+    publish(Entity::Vehicle, Change::Updated, vehicleIt->second);
+  }
+
+  WorkOrder w(store_.itemArena.resource());
+  w.id = generateId("WO", static_cast<int>(store_.workOrders.size()) + archivedOrders_ + 1);
+  w.vehicle = vehicle;
+  w.customer = store_.customers[customerIt->second];
+  w.advisor.id = "SA001"; w.advisor.name = "Advisor"; // simple demo advisor
+  w.lifecycle.created = StageStamp::now();
+
+  auto detection = MaintenanceDetector::detect(vehicle, storeHouse_.snapshot(), &store_.serviceHistory);
+  w.items = std::move(detection.items);
+  w.detectionNote = std::move(detection.note);
+  w.items.insert(w.items.end(), extraItems.begin(), extraItems.end());
+
+  w.assign(tech);
+  store_.lifecycleStats.observe(w);
+
+  const std::size_t row = store_.workOrders.size();
+  attachOrderToTech(techId, w.id);
+  orderById_.emplace(w.id, row);
+  orderByVin_.emplace(vin, row);
+  store_.workOrders.push_back(std::move(w));
+  store_.orderColumns.sync(row, store_.workOrders[row]);
+  countTransition(store_.workOrders[row].status);
+  publish(Entity::WorkOrder, Change::Added, row);
+  return row;
+}
+
+void WorkshopService::assign(std::size_t row, const std::string& techId, std::optional<std::uint64_t> expectedVersion) {
+  auto& w = order(row, expectedVersion);
+  const auto& tech = technician(techId);
+  // Reassigning changes the labor rate, so the saved header total no longer applies
+  DataStorePersistence::hydrate(w);
+  const bool reassigned = w.status == WOStatus::Assigned;
+  w.assign(tech);
+  detachOrderFromAllTechs(w.id);
+  attachOrderToTech(techId, w.id);
+  orderChanged(row, !reassigned);
+}
+
+void WorkshopService::start(std::size_t row, std::optional<std::uint64_t> expectedVersion) {
+  auto& w = order(row, expectedVersion);
+  DataStorePersistence::hydrate(w);
+  w.start();
+  orderChanged(row);
+}
+
+void WorkshopService::complete(std::size_t row, std::optional<std::uint64_t> expectedVersion) {
+  auto& w = order(row, expectedVersion);
+  DataStorePersistence::hydrate(w);
+  w.complete();
+  orderChanged(row);
+}
+
+SettleResult WorkshopService::settle(std::size_t row, std::optional<std::uint64_t> expectedVersion) {
+  TRACE_SCOPE("service.settle");
+  auto& w = order(row, expectedVersion);
+  DataStorePersistence::hydrate(w);
+  SettleResult result;
+  result.total = w.settle();
+  store_.serviceHistory.record(w);
+  store_.turnoverRollup.add(w);
+  result.partsConsumed = storeHouse_.consumeForOrder(w, &result.alerts);
+  w.partsConsumed = result.partsConsumed;
+  store_.topN.record(w, result.partsConsumed);
+  if (result.partsConsumed) {
+    std::vector<IdHandle> changed;
+    for (const auto& item : w.items) {
+      for (const auto& pr : item.parts) {
+        const auto handle = partHandle(pr.first);
+        if (std::find(changed.begin(), changed.end(), handle) != changed.end()) continue;
+        changed.push_back(handle);
+        partChanged(handle);
+      }
+    }
+  }
+  orderChanged(row);
+  return result;
+}
+
+template <class Update>
+bool WorkshopService::updatePart(std::optional<std::uint64_t> expectedVersion, Update&& update) {
+  auto& counters = conflicts_.of(Versioned::Part);
+  if (expectedVersion) ++counters.checks;
+  try {
+    return update();
+  } catch (const VersionConflict&) {
+    ++counters.conflicts;
+    throw;
+  }
+}
+
+bool WorkshopService::receiveStock(const std::string& partId, int qty, std::optional<std::uint64_t> expectedVersion) {
+  if (qty <= 0) throw std::runtime_error("Received quantity must be positive");
+  if (!updatePart(expectedVersion, [&] { return storeHouse_.receive(partId, qty, expectedVersion); })) return false;
+  partChanged(IdTable::parts().find(partId));
+  return true;
+}
+
+bool WorkshopService::setStock(const std::string& partId, int stock, std::optional<std::uint64_t> expectedVersion) {
+  if (stock < 0) throw std::runtime_error("Stock cannot be negative");
+  if (!updatePart(expectedVersion, [&] { return storeHouse_.setStock(partId, stock, expectedVersion); })) return false;
+  partChanged(IdTable::parts().find(partId));
+  return true;
+}
+
+bool WorkshopService::adjustStock(const std::string& partId, int delta) {
+  if (!storeHouse_.adjust(partId, delta)) return false;
+  partChanged(IdTable::parts().find(partId));
+  return true;
+}
+
+std::optional<std::size_t> WorkshopService::findOrder(const std::string& idOrVin) const {
+  auto it = orderById_.find(idOrVin);
+  if (it != orderById_.end()) return it->second;
+  it = orderByVin_.find(idOrVin);
+  if (it != orderByVin_.end()) return it->second;
+  return std::nullopt;
+}
+
+WorkOrder& WorkshopService::order(std::size_t row) {
+  if (row >= store_.workOrders.size()) throw std::runtime_error("No such work order");
+  return store_.workOrders[row];
+}
+
+WorkOrder& WorkshopService::order(std::size_t row, std::optional<std::uint64_t> expectedVersion) {
+  auto& w = order(row);
+  if (!expectedVersion) return w;
+  auto& counters = conflicts_.of(Versioned::WorkOrder);
+  ++counters.checks;
+  if (*expectedVersion != w.version) {
+    ++counters.conflicts;
+    throw VersionConflict(Versioned::WorkOrder, w.id, *expectedVersion, w.version);
+  }
+  return w;
+}
+
+const Technician& WorkshopService::technician(const std::string& techId) const {
+  auto it = technicianById_.find(techId);
+  if (it == technicianById_.end()) throw std::runtime_error("Unknown mechanic " + techId);
+  return store_.technicians[it->second];
+}
+
+void WorkshopService::orderChanged(std::size_t row, bool transitioned) {
+  const auto& w = store_.workOrders[row];
+  if (isClosed(w.status)) {
+    // A paid vehicle can be booked in again
+    auto it = orderByVin_.find(w.vehicle.vin);
+    if (it != orderByVin_.end() && it->second == row) orderByVin_.erase(it);
+  }
+  if (transitioned) store_.lifecycleStats.observe(store_.workOrders[row]);
+  store_.orderColumns.sync(row, store_.workOrders[row]);
+  if (transitioned) countTransition(store_.workOrders[row].status);
+  publish(Entity::WorkOrder, Change::Updated, row);
+}
+
+void WorkshopService::indexParts() {
+  partRow_.assign(IdTable::parts().size(), store_.parts.size());
+  for (std::size_t i = 0; i < store_.parts.size(); ++i) {
+    auto& p = store_.parts[i];
+    p.handle = IdTable::parts().intern(p.id);
+    if (p.handle >= partRow_.size()) partRow_.resize(p.handle + 1, store_.parts.size());
+    partRow_[p.handle] = i;
+  }
+}
+
+void WorkshopService::partChanged(IdHandle handle) {
+  auto part = storeHouse_.find(handle);
+  if (!part) return;
+  auto row = partRow(handle);
+  // Views may have replaced DataStore::parts with a reordered snapshot
+  if (row >= store_.parts.size() || partHandle(store_.parts[row]) != handle) {
+    indexParts();
+    row = partRow(handle);
+    if (row >= store_.parts.size()) {
+      if (handle >= partRow_.size()) partRow_.resize(handle + 1, store_.parts.size());
+      row = partRow_[handle] = store_.parts.size();
+      store_.parts.push_back(*part);
+    }
+  }
+  store_.parts[row] = *part;
+  publish(Entity::Part, Change::Updated, row);
+}
+
+void WorkshopService::attachOrderToTech(const std::string& techId, const std::string& woId) {
+  auto it = technicianById_.find(techId);
+  if (it == technicianById_.end()) return;
+  const auto wo = IdTable::workOrders().intern(woId);
+  auto& list = store_.technicians[it->second].assignedWorkOrders;
+  if (std::find(list.begin(), list.end(), wo) != list.end()) return;
+  list.push_back(wo);
+  publish(Entity::Technician, Change::Updated, it->second);
+}
+
+void WorkshopService::detachOrderFromAllTechs(const std::string& woId) {
+  const auto wo = IdTable::workOrders().find(woId);
+  if (wo == kNoHandle) return;
+  for (std::size_t i = 0; i < store_.technicians.size(); ++i) {
+    auto& list = store_.technicians[i].assignedWorkOrders;
+    auto tail = std::remove(list.begin(), list.end(), wo);
+    if (tail == list.end()) continue;
+    list.erase(tail, list.end());
+    publish(Entity::Technician, Change::Updated, i);
+  }
+}
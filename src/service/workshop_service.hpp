@@ -0,0 +1,105 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "domain/change_bus.hpp"
+#include "domain/data_store.hpp"
+#include "domain/versioning.hpp"
+#include "inventory/store_house.hpp"
+
+struct SettleResult {
+  double total{0};
+  bool partsConsumed{false};
+  std::vector<std::string> alerts; // low-stock alerts raised by this order's parts
+};
+
+// The one place where entities are added and work orders move through their
+// lifecycle, shared by the GUI and the headless batch runner. Each mutation
+// keeps the store's derived indexes in step and publishes a ChangeEvent when
+// a bus is attached. Invalid operations throw std::runtime_error and leave
+// the store unchanged. Nothing here saves; callers decide when to persist.
+//
+// Updates take an optional expected version of the order or part. When it
+// is given and stale, VersionConflict is thrown and the update is dropped.
+class WorkshopService {
+public:
+  // archivedOrders offsets generated work order ids past archived ones.
+  WorkshopService(DataStore& store, StoreHouse& storeHouse, int archivedOrders = 0);
+
+  void setChangeBus(const ChangeBus* bus) { bus_ = bus; }
+  void setArchivedOrders(int archivedOrders) { archivedOrders_ = archivedOrders; }
+  // Rebuilds the lookup tables after the store was replaced wholesale.
+  void reindex();
+
+  // An empty customer id is generated.
+  const Customer& addCustomer(Customer c);
+  void addVehicle(const Vehicle& v);
+  void addTechnician(const Technician& t);
+  // Stores hours derived by a payroll run; publishes only when they change.
+  void setHoursWorked(const std::string& techId, double hours);
+
+  // Creates an order for the vehicle with the detector's proposals plus
+  // `extraItems`, assigned to the technician. Returns its row. A vehicle
+  // may have one open order at a time. `mileage` is the odometer read at
+  // check-in; it becomes the vehicle's mileage before detection runs, and
+  // 0 keeps the last known reading.
+  std::size_t createOrder(const std::string& vin, const std::string& techId, int mileage = 0,
+                          const std::vector<WOItem>& extraItems = {});
+  // Assigns a Draft order or reassigns one not yet started.
+  void assign(std::size_t row, const std::string& techId, std::optional<std::uint64_t> expectedVersion = std::nullopt);
+  void start(std::size_t row, std::optional<std::uint64_t> expectedVersion = std::nullopt);
+  void complete(std::size_t row, std::optional<std::uint64_t> expectedVersion = std::nullopt);
+  SettleResult settle(std::size_t row, std::optional<std::uint64_t> expectedVersion = std::nullopt);
+  // Stock operations return false if the part does not exist.
+  bool receiveStock(const std::string& partId, int qty, std::optional<std::uint64_t> expectedVersion = std::nullopt);
+  bool setStock(const std::string& partId, int stock, std::optional<std::uint64_t> expectedVersion = std::nullopt);
+  // Changes the stock by `delta` in one step under the storehouse lock;
+  // refuses to go below zero.
+  bool adjustStock(const std::string& partId, int delta);
+
+  const ConflictMetrics& conflictMetrics() const { return conflicts_; }
+  ConflictMetrics& conflictMetrics() { return conflicts_; }
+
+  // Row of the order with this id, or of the open order for this VIN.
+  std::optional<std::size_t> findOrder(const std::string& idOrVin) const;
+  // Whether the vehicle has an order that is not yet paid or cancelled
+  bool vehicleHasOrder(const std::string& vin) const { return orderByVin_.count(vin) > 0; }
+
+private:
+  DataStore& store_;
+  StoreHouse& storeHouse_;
+  const ChangeBus* bus_{};
+  int archivedOrders_{0};
+  ConflictMetrics conflicts_;
+
+  std::unordered_map<std::string, std::size_t> vehicleByVin_;
+  std::unordered_map<std::string, std::size_t> technicianById_;
+  std::unordered_map<std::string, std::size_t> customerById_;
+  std::unordered_map<std::string, std::size_t> orderById_;
+  std::unordered_map<std::string, std::size_t> orderByVin_; // open orders only
+  std::vector<std::size_t> partRow_; // part handle -> row of DataStore::parts
+
+  WorkOrder& order(std::size_t row);
+  // The order at `row` after checking `expectedVersion` against it
+  WorkOrder& order(std::size_t row, std::optional<std::uint64_t> expectedVersion);
+  template <class Update>
+  bool updatePart(std::optional<std::uint64_t> expectedVersion, Update&& update);
+  const Technician& technician(const std::string& techId) const;
+  // `transitioned` is false for edits that keep the status, such as a
+  // reassignment, so stage latencies and transition counts are not repeated
+  void orderChanged(std::size_t row, bool transitioned = true);
+  void indexParts();
+  // Row of the part in DataStore::parts, or past the end when it has none
+  std::size_t partRow(IdHandle part) const {
+    return part < partRow_.size() ? partRow_[part] : store_.parts.size();
+  }
+  // Copies the storehouse's part into DataStore::parts and publishes it
+  void partChanged(IdHandle part);
+  void attachOrderToTech(const std::string& techId, const std::string& woId);
+  void detachOrderFromAllTechs(const std::string& woId);
+  void publish(Entity entity, Change change, std::size_t row) const {
+    if (bus_) bus_->publish(entity, change, row);
+  }
+};
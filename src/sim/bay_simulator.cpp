@@ -0,0 +1,167 @@
+#include "sim/bay_simulator.hpp"
+#include "domain/data_store.hpp"
+#include "service/workshop_service.hpp"
+#include "trace/tracer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// Parts the detector proposes, with the most an order can use
+struct PartDemand {
+  Part part;
+  int perOrder;
+};
+
+const PartDemand kCatalog[] = {
+  {{"P001", "Engine Oil", 50, 0, 5, 0}, 4},
+  {{"P002", "Oil Filter", 30, 0, 4, 0}, 1},
+  {{"P003", "Air Filter", 45, 0, 3, 0}, 1},
+  {{"P004", "Brake Pads", 120, 0, 2, 0}, 1},
+};
+
+const char* const kBrands[] = {"Toyota", "Honda", "BYD", "Volkswagen", "Ford"};
+
+std::int64_t microsSince(Clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+}
+
+struct BayResult {
+  std::size_t orders{0};
+  std::size_t stockouts{0};
+  std::size_t errors{0};
+  std::map<std::string, LatencyHistogram> operations;
+  LatencyHistogram turnaround;
+};
+
+void runBay(int bay, const SimConfig& config, StoreHouse& storeHouse, Clock::time_point opening, BayResult& out) {
+  Tracer::setThreadName("bay " + std::to_string(bay + 1));
+  DataStore store;
+  for (const auto& d : kCatalog) store.parts.push_back(d.part);
+  store.customers.push_back(Customer{"C" + std::to_string(bay + 1), "Walk-in " + std::to_string(bay + 1), "", 0});
+  Technician tech;
+  tech.id = "E" + std::to_string(100 + bay);
+  tech.name = "Bay " + std::to_string(bay + 1);
+  store.technicians.push_back(tech);
+  WorkshopService service(store, storeHouse);
+
+  std::mt19937_64 rng(config.seed + static_cast<std::uint64_t>(bay) * 0x9E3779B97F4A7C15ULL);
+  std::exponential_distribution<double> interArrival(config.arrivalsPerSecond > 0 ? config.arrivalsPerSecond : 1);
+  std::uniform_int_distribution<int> year(2008, 2025);
+  std::uniform_int_distribution<int> mileage(5000, 250000);
+  std::uniform_int_distribution<std::size_t> brand(0, std::size(kBrands) - 1);
+
+  auto timed = [&](const char* op, auto&& call) {
+    const auto start = Clock::now();
+    call();
+    out.operations[op].record(microsSince(start));
+  };
+  auto work = [&] {
+    if (config.workUs > 0) std::this_thread::sleep_for(std::chrono::microseconds(config.workUs));
+  };
+
+  auto arrival = opening;
+  for (int i = 0; i < config.ordersPerBay; ++i) {
+    if (config.arrivalsPerSecond > 0) {
+      arrival += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(interArrival(rng)));
+      // A bay running behind serves the queue without waiting
+      std::this_thread::sleep_until(arrival);
+    } else {
+      arrival = Clock::now();
+    }
+    char vin[32];
+    snprintf(vin, sizeof(vin), "SIM%02d%07d", bay, i);
+    Vehicle v{vin, vin, kBrands[brand(rng)], "Sim", year(rng), store.customers[0].id, mileage(rng)};
+    try {
+      service.addVehicle(v);
+      std::size_t row = 0;
+      timed("create", [&] { row = service.createOrder(v.vin, tech.id); });
+      work();
+      timed("start", [&] { service.start(row); });
+      work();
+      timed("complete", [&] { service.complete(row); });
+      work();
+      SettleResult settled;
+      timed("settle", [&] { settled = service.settle(row); });
+      out.turnaround.record(microsSince(arrival));
+      ++out.orders;
+      if (!settled.partsConsumed) ++out.stockouts;
+    } catch (const std::exception&) {
+      ++out.errors;
+    }
+  }
+}
+}
+
+SimReport BaySimulator::run(const SimConfig& config) {
+  const auto totalOrders = static_cast<double>(config.bays) * config.ordersPerBay;
+  std::vector<Part> opening;
+  for (const auto& d : kCatalog) {
+    Part p = d.part;
+    p.stock = static_cast<int>(std::ceil(config.stockCover * d.perOrder * totalOrders));
+    p.capacity = std::max(p.stock, 1);
+    opening.push_back(p);
+  }
+  StoreHouse storeHouse(opening);
+
+  SimReport report;
+  std::vector<BayResult> results(static_cast<std::size_t>(config.bays));
+  std::vector<std::thread> bays;
+  const auto start = Clock::now();
+  for (int b = 0; b < config.bays; ++b) {
+    bays.emplace_back(runBay, b, std::cref(config), std::ref(storeHouse), start, std::ref(results[b]));
+  }
+
+  // The supplier tops the shelves up until the last bay closes
+  std::mutex closingMutex;
+  std::condition_variable closingCv;
+  bool closed = false;
+  std::thread supplier;
+  if (config.restockCover > 0 && config.restockMs > 0 && config.arrivalsPerSecond > 0) {
+    supplier = std::thread([&] {
+      Tracer::setThreadName("supplier");
+      const double ordersPerDelivery = config.bays * config.arrivalsPerSecond * config.restockMs / 1000.0;
+      std::unique_lock<std::mutex> guard(closingMutex);
+      while (!closingCv.wait_for(guard, std::chrono::milliseconds(config.restockMs), [&] { return closed; })) {
+        for (const auto& d : kCatalog) {
+          const auto qty = static_cast<int>(std::ceil(config.restockCover * d.perOrder * ordersPerDelivery));
+          storeHouse.receive(d.part.id, qty);
+        }
+        ++report.deliveries;
+      }
+    });
+  }
+
+  for (auto& t : bays) t.join();
+  report.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  if (supplier.joinable()) {
+    {
+      std::lock_guard<std::mutex> guard(closingMutex);
+      closed = true;
+    }
+    closingCv.notify_one();
+    supplier.join();
+  }
+
+  for (const auto& r : results) {
+    report.orders += r.orders;
+    report.stockouts += r.stockouts;
+    report.errors += r.errors;
+    for (const auto& op : r.operations) report.operations[op.first].merge(op.second);
+    report.turnaround.merge(r.turnaround);
+  }
+  report.storeHouse = storeHouse.stats();
+  return report;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include "inventory/store_house.hpp"
+#include "report/latency_histogram.hpp"
+
+struct SimConfig {
+  int bays{4};
+  int ordersPerBay{250};
+  double arrivalsPerSecond{100}; // per bay, Poisson; 0 lets orders arrive back to back
+  int workUs{0};                 // time a mechanic spends between stages
+  double stockCover{1.0};        // opening stock as a fraction of the run's expected part demand
+  double restockCover{0};        // deliveries as a fraction of the expected consumption rate
+  int restockMs{100};            // delivery interval
+  std::uint64_t seed{42};
+};
+
+struct SimReport {
+  double seconds{0};
+  std::size_t orders{0};   // orders settled
+  std::size_t stockouts{0}; // settled without their parts
+  std::size_t errors{0};   // rejected operations
+  std::size_t deliveries{0};
+  std::map<std::string, LatencyHistogram> operations; // µs per service call, by operation
+  LatencyHistogram turnaround; // µs from an order's arrival to its settlement
+  StoreHouseStats storeHouse;
+
+  double ordersPerSecond() const { return seconds > 0 ? orders / seconds : 0; }
+};
+
+// Runs a workshop day: each bay is a thread with its own books (DataStore
+// and WorkshopService) taking vehicles as they arrive and driving them
+// through create (detection and assignment), start, complete and settle.
+// All bays draw parts from one StoreHouse, optionally restocked by a
+// supplier thread. Runs are repeatable for a given seed, up to thread
+// scheduling.
+class BaySimulator {
+public:
+  static SimReport run(const SimConfig& config);
+};
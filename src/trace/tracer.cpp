@@ -0,0 +1,157 @@
+#include "trace/tracer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+struct SpanRecord {
+  const char* name;
+  std::int64_t startNs;
+  std::int64_t durationNs;
+};
+
+// One thread's spans. The owner appends under `mutex`, which is only
+// contended while a dump copies the ring.
+struct Ring {
+  std::mutex mutex;
+  std::vector<SpanRecord> spans;
+  std::uint64_t written{0};
+  std::string name;
+  int tid{0};
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::shared_ptr<Ring>> rings; // kept after their thread exits
+  std::string outputPath;
+  const std::int64_t originNs = Tracer::nowNs();
+};
+
+Registry& registry() {
+  static Registry instance;
+  return instance;
+}
+
+Ring& localRing() {
+  thread_local std::shared_ptr<Ring> ring = [] {
+    auto r = std::make_shared<Ring>();
+    auto& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.mutex);
+    r->tid = static_cast<int>(reg.rings.size()) + 1;
+    reg.rings.push_back(r);
+    return r;
+  }();
+  return *ring;
+}
+
+void writeEscaped(std::ostream& out, const std::string& text) {
+  for (char c : text) {
+    if (c == '"' || c == '\\') out << '\\' << c;
+    else if (static_cast<unsigned char>(c) < 0x20) out << ' ';
+    else out << c;
+  }
+}
+}
+
+std::int64_t Tracer::nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracer::setEnabled(bool on) {
+#if AUTO_REPAIR_TRACING
+  registry(); // fixes the time origin before the first span
+  enabled_.store(on, std::memory_order_relaxed);
+#else
+  (void)on;
+#endif
+}
+
+void Tracer::setThreadName(const std::string& name) {
+  auto& ring = localRing();
+  std::lock_guard<std::mutex> guard(ring.mutex);
+  ring.name = name;
+}
+
+void Tracer::record(const char* name, std::int64_t startNs, std::int64_t durationNs) {
+  auto& ring = localRing();
+  std::lock_guard<std::mutex> guard(ring.mutex);
+  if (ring.spans.empty()) ring.spans.resize(kRingSize); // threads that never trace stay small
+  ring.spans[ring.written++ % kRingSize] = SpanRecord{name, startNs, durationNs};
+}
+
+void Tracer::installFromEnvironment() {
+  const char* path = std::getenv(kEnvironmentVariable);
+  if (!path || !*path) return;
+  {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.mutex);
+    reg.outputPath = path;
+  }
+  setEnabled(true);
+  // Registered after the registry exists, so it runs before its destruction
+  std::atexit([] {
+    const auto path = outputPath();
+    if (!dump(path)) std::fprintf(stderr, "cannot write trace %s\n", path.c_str());
+  });
+}
+
+std::string Tracer::outputPath() {
+  auto& reg = registry();
+  std::lock_guard<std::mutex> guard(reg.mutex);
+  return reg.outputPath.empty() ? "auto_repair_trace.json" : reg.outputPath;
+}
+
+void Tracer::writeJson(std::ostream& out) {
+  auto& reg = registry();
+  std::vector<std::shared_ptr<Ring>> rings;
+  {
+    std::lock_guard<std::mutex> guard(reg.mutex);
+    rings = reg.rings;
+  }
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  auto separator = [&] {
+    if (!first) out << ",\n";
+    first = false;
+  };
+  char number[64];
+  for (const auto& ring : rings) {
+    std::vector<SpanRecord> spans;
+    std::string name;
+    {
+      std::lock_guard<std::mutex> guard(ring->mutex);
+      const auto kept = std::min<std::uint64_t>(ring->written, kRingSize);
+      spans.reserve(kept);
+      for (auto i = ring->written - kept; i < ring->written; ++i) spans.push_back(ring->spans[i % kRingSize]);
+      name = ring->name;
+    }
+    separator();
+    out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << ring->tid << ",\"args\":{\"name\":\"";
+    writeEscaped(out, name.empty() ? "thread " + std::to_string(ring->tid) : name);
+    out << "\"}}";
+    for (const auto& s : spans) {
+      separator();
+      // Chrome wants microseconds; keep the nanoseconds as decimals
+      std::snprintf(number, sizeof(number), "\"ts\":%.3f,\"dur\":%.3f", (s.startNs - reg.originNs) / 1000.0,
+                    s.durationNs / 1000.0);
+      out << "{\"ph\":\"X\",\"cat\":\"auto_repair\",\"name\":\"";
+      writeEscaped(out, s.name);
+      out << "\",\"pid\":1,\"tid\":" << ring->tid << ',' << number << '}';
+    }
+  }
+  out << "]}\n";
+}
+
+bool Tracer::dump(const std::string& path) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) return false;
+  writeJson(out);
+  out.flush();
+  return static_cast<bool>(out);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#ifndef AUTO_REPAIR_TRACING
+#define AUTO_REPAIR_TRACING 1
+#endif
+
+// Scoped-span tracing for finding where time goes. TRACE_SCOPE("name")
+// records how long the rest of the enclosing scope takes into a ring buffer
+// owned by the calling thread; each thread keeps its latest kRingSize spans.
+// The buffers are written as Chrome trace-event JSON, which chrome://tracing
+// and ui.perfetto.dev open as a per-thread timeline.
+//
+// A span costs two clock reads and an uncontended lock while tracing is on,
+// and one relaxed load while it is off. Configuring with
+// -DAUTO_REPAIR_TRACING=OFF compiles the spans out. Span names must be
+// string literals: only the pointer is stored.
+class Tracer {
+public:
+  static constexpr std::size_t kRingSize = 1 << 14;
+  static constexpr const char* kEnvironmentVariable = "AUTO_REPAIR_TRACE";
+
+  class Scope {
+  public:
+    explicit Scope(const char* name) : name_(name), startNs_(enabled() ? nowNs() : -1) {}
+    ~Scope() {
+      if (startNs_ >= 0) record(name_, startNs_, nowNs() - startNs_);
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    const char* name_;
+    std::int64_t startNs_;
+  };
+
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+  static void setEnabled(bool on);
+  // Labels the calling thread's track in the trace.
+  static void setThreadName(const std::string& name);
+
+  // If AUTO_REPAIR_TRACE names a file, turns tracing on and writes that file
+  // at exit. Call once from main.
+  static void installFromEnvironment();
+  // Where an on-demand dump goes: the AUTO_REPAIR_TRACE file, or
+  // auto_repair_trace.json in the working directory.
+  static std::string outputPath();
+
+  static void writeJson(std::ostream& out);
+  static bool dump(const std::string& path);
+
+  static std::int64_t nowNs();
+
+private:
+  static inline std::atomic<bool> enabled_{false};
+
+  static void record(const char* name, std::int64_t startNs, std::int64_t durationNs);
+};
+
+#if AUTO_REPAIR_TRACING
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) Tracer::Scope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) static_cast<void>(0)
+#endif
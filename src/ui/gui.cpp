@@ -7,49 +7,110 @@
 #include <QMessageBox>
 #include <QHeaderView>
 #include <QDoubleSpinBox>
+#include <QDateTime>
+#include <QFileDialog>
 #include <QStringList>
+#include <QTimer>
+#include <QStatusBar>
+#include <QShortcut>
 #include <algorithm>
 #include <map>
 #include <cstdio>
-#include "domain/maintenance_detector.hpp"
 #include "report/report_service.hpp"
+#include "report/report_exporter.hpp"
+#include "report/payroll.hpp"
 #include "persistence/data_store_persistence.hpp"
-
-namespace {
-std::string generateId(const std::string& prefix, int number) {
-  char buf[32];
-  snprintf(buf, sizeof(buf), "%s%04d", prefix.c_str(), number);
-  return std::string(buf);
-}
-
-QString statusToText(WOStatus st) {
-  switch (st) {
-    case WOStatus::Draft: return "Draft";
-    case WOStatus::Assigned: return "Assigned";
-    case WOStatus::InProgress: return "In Progress";
-    case WOStatus::Completed: return "Completed";
-    case WOStatus::Paid: return "Paid";
-    case WOStatus::Cancelled: return "Cancelled";
-  }
-  return "Unknown";
+#include "persistence/store_bootstrap.hpp"
+#include "trace/tracer.hpp"
+
+struct MainWindow::LoadedState {
+  DataStore store;
+  SearchIndex search;
+};
+
+MainWindow::MainWindow(const QString& dataPath, QWidget* parent)
+    : QMainWindow(parent), dataPath_(dataPath), archive_(WorkOrderArchive::directoryFor(dataPath.toStdString())) {
+  changes_.addObserver(this);
+  workshop_.setChangeBus(&changes_);
+  saveTimer_.setInterval(1000);
+  connect(&saveTimer_, &QTimer::timeout, this, &MainWindow::saveIfDirty);
+  setupUI();
+  tabs_->setEnabled(false);
+  loadProgress_ = new QProgressBar(this);
+  loadProgress_->setRange(0, 100);
+  loadProgress_->setFormat(tr("Loading %p%"));
+  loadProgress_->setMaximumWidth(240);
+  statusBar()->addPermanentWidget(loadProgress_);
+  startLoading();
 }
 
-QString joinIds(const std::vector<std::string>& ids) {
-  QStringList list;
-  for (const auto& id : ids) list << QString::fromStdString(id);
-  return list.join(", ");
+MainWindow::~MainWindow() {
+  // The loader writes to archive_ and posts back to this window
+  if (loader_) loader_->wait();
+  saveIfDirty();
 }
+
+void MainWindow::startLoading() {
+  const std::string path = dataPath_.toStdString();
+  auto* bar = loadProgress_;
+  loader_.reset(QThread::create([this, path, bar] {
+    Tracer::setThreadName("loader");
+    auto progress = [bar](int percent) {
+      QMetaObject::invokeMethod(bar, [bar, percent] { bar->setValue(percent); }, Qt::QueuedConnection);
+    };
+    auto state = std::make_shared<LoadedState>();
+    state->store = StoreBootstrap::loadOrSeed(path, progress);
+    // archive_ is not touched by the GUI thread until finishLoading
+    StoreBootstrap::archiveAged(state->store, archive_, path);
+    progress(95);
+    TRACE_SCOPE("search.build");
+    for (const auto& v : state->store.vehicles) state->search.addVehicle(v);
+    for (const auto& c : state->store.customers) state->search.addCustomer(c);
+    for (const auto& p : state->store.parts) state->search.addPart(p);
+    QMetaObject::invokeMethod(this, [this, state] { finishLoading(state); }, Qt::QueuedConnection);
+  }));
+  loader_->start();
 }
 
-MainWindow::MainWindow(DataStore store, const QString& dataPath, QWidget* parent)
-    : QMainWindow(parent), store_(std::move(store)), dataPath_(dataPath) {
+void MainWindow::finishLoading(const std::shared_ptr<LoadedState>& state) {
+  TRACE_SCOPE("gui.finishLoading");
+  // Move-assigning keeps the vectors the table models refer to
+  store_ = std::move(state->store);
+  search_ = std::move(state->search);
+  inventoryModel_->reload();
   storeHouse_.seed(store_.parts);
-  setupUI();
+  workshop_.setArchivedOrders(archive_.archivedCount());
+  workshop_.reindex();
+  saveTimer_.start();
+  // Reporting followers reload the saved store and replay from here
+  changeLog_.restart();
+  changes_.addObserver(&changeLog_);
+
+  statusBar()->removeWidget(loadProgress_);
+  loadProgress_->deleteLater();
+  loadProgress_ = nullptr;
+  statusBar()->showMessage(tr("Loaded %1 work orders").arg(store_.workOrders.size()), 3000);
+  tabs_->setEnabled(true);
+
+  // Customers first; the other tabs fill when first opened
   populateCustomers();
-  populateTechnicians();
-  populateWorkOrders();
-  populateSelectors();
-  updateSummary();
+  stalePages_ = {workOrderPage_, technicianPage_, summaryPage_};
+  connect(tabs_, &QTabWidget::currentChanged, this, &MainWindow::fillPageOnFirstOpen);
+  fillPageOnFirstOpen(tabs_->currentIndex());
+}
+
+void MainWindow::fillPageOnFirstOpen(int index) {
+  auto* page = tabs_->widget(index);
+  if (!stalePages_.erase(page)) return;
+  if (page == workOrderPage_) {
+    TRACE_SCOPE("gui.populateWorkOrders");
+    workOrderModel_->showRows(static_cast<int>(store_.workOrders.size()));
+    populateSelectors();
+  } else if (page == technicianPage_) {
+    technicianModel_->showRows(static_cast<int>(store_.technicians.size()));
+  } else if (page == summaryPage_) {
+    updateSummary();
+  }
 }
 
 void MainWindow::setupUI() {
@@ -57,10 +118,16 @@ void MainWindow::setupUI() {
   tabs_ = new QTabWidget(this);
   setCentralWidget(tabs_);
   tabs_->addTab(buildCustomerPage(), tr("Customers"));
-  tabs_->addTab(buildWorkOrderPage(), tr("Work Orders"));
-  tabs_->addTab(buildTechnicianPage(), tr("Mechanics"));
-  tabs_->addTab(buildSummaryPage(), tr("Summary"));
+  workOrderPage_ = buildWorkOrderPage();
+  technicianPage_ = buildTechnicianPage();
+  summaryPage_ = buildSummaryPage();
+  tabs_->addTab(workOrderPage_, tr("Work Orders"));
+  tabs_->addTab(technicianPage_, tr("Mechanics"));
+  tabs_->addTab(summaryPage_, tr("Summary"));
   tabs_->addTab(buildHelpPage(), tr("Help"));
+
+  auto* traceShortcut = new QShortcut(QKeySequence(tr("Ctrl+Shift+T")), this);
+  connect(traceShortcut, &QShortcut::activated, this, &MainWindow::dumpTrace);
 }
 
 QWidget* MainWindow::buildCustomerPage() {
@@ -91,8 +158,9 @@ QWidget* MainWindow::buildCustomerPage() {
   // Right side: vehicles for selected customer
   auto* right = new QVBoxLayout();
   right->addWidget(new QLabel(tr("Vehicles"), page));
-  vehicleTable_ = new QTableWidget(0, 5, page);
-  vehicleTable_->setHorizontalHeaderLabels({tr("VIN"), tr("Plate"), tr("Brand"), tr("Model"), tr("Year")});
+  vehicleTable_ = new QTableView(page);
+  vehicleModel_ = new VehicleTableModel(store_.vehicles, this);
+  vehicleTable_->setModel(vehicleModel_);
   vehicleTable_->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
   right->addWidget(vehicleTable_);
 
@@ -103,11 +171,16 @@ QWidget* MainWindow::buildCustomerPage() {
   model_ = new QLineEdit(page);
   year_ = new QSpinBox(page);
   year_->setRange(1980, 2100);
+  mileage_ = new QSpinBox(page);
+  mileage_->setRange(0, 2000000);
+  mileage_->setSingleStep(1000);
+  mileage_->setSuffix(tr(" km"));
   vehicleForm->addRow(tr("VIN"), vin_);
   vehicleForm->addRow(tr("Plate"), plate_);
   vehicleForm->addRow(tr("Brand"), brand_);
   vehicleForm->addRow(tr("Model"), model_);
   vehicleForm->addRow(tr("Year"), year_);
+  vehicleForm->addRow(tr("Mileage"), mileage_);
   auto* addVehicleBtn = new QPushButton(tr("Add Vehicle"), page);
   connect(addVehicleBtn, &QPushButton::clicked, this, &MainWindow::addVehicle);
   right->addLayout(vehicleForm);
@@ -123,8 +196,9 @@ QWidget* MainWindow::buildTechnicianPage() {
   auto* page = new QWidget(this);
   auto* layout = new QVBoxLayout(page);
 
-  technicianTable_ = new QTableWidget(0, 4, page);
-  technicianTable_->setHorizontalHeaderLabels({tr("ID"), tr("Name"), tr("Hourly Rate"), tr("Assigned Orders")});
+  technicianTable_ = new QTableView(page);
+  technicianModel_ = new TechnicianTableModel(store_.technicians, this);
+  technicianTable_->setModel(technicianModel_);
   technicianTable_->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
   layout->addWidget(new QLabel(tr("Mechanics"), page));
   layout->addWidget(technicianTable_);
@@ -150,14 +224,32 @@ QWidget* MainWindow::buildWorkOrderPage() {
   auto* page = new QWidget(this);
   auto* layout = new QVBoxLayout(page);
 
-  workOrderTable_ = new QTableWidget(0, 7, page);
-  workOrderTable_->setHorizontalHeaderLabels({tr("ID"), tr("Vehicle"), tr("Customer"), tr("Mechanic"), tr("Status"), tr("Total"), tr("Detection")});
+  searchBox_ = new QLineEdit(page);
+  searchBox_->setPlaceholderText(tr("Search plate, VIN, customer name/phone or part"));
+  searchBox_->setClearButtonEnabled(true);
+  searchResults_ = new QListWidget(page);
+  searchResults_->setMaximumHeight(120);
+  connect(searchBox_, &QLineEdit::textChanged, this, &MainWindow::runSearch);
+  connect(searchResults_, &QListWidget::itemActivated, this, &MainWindow::openSearchHit);
+  layout->addWidget(searchBox_);
+  layout->addWidget(searchResults_);
+
+  workOrderTable_ = new QTableView(page);
+  workOrderModel_ = new WorkOrderTableModel(store_.workOrders, this);
+  workOrderTable_->setModel(workOrderModel_);
+  workOrderTable_->setSelectionBehavior(QAbstractItemView::SelectRows);
+  workOrderTable_->setSelectionMode(QAbstractItemView::SingleSelection);
   workOrderTable_->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
   layout->addWidget(workOrderTable_);
 
   auto* form = new QFormLayout();
   vehicleSelect_ = new QComboBox(page);
   techSelect_ = new QComboBox(page);
+  orderMileage_ = new QSpinBox(page);
+  orderMileage_->setRange(0, 2000000);
+  orderMileage_->setSingleStep(1000);
+  orderMileage_->setSuffix(tr(" km"));
+  orderMileage_->setSpecialValueText(tr("Not read"));
   serviceId_ = new QLineEdit(page);
   serviceName_ = new QLineEdit(page);
   laborHours_ = new QDoubleSpinBox(page);
@@ -176,6 +268,7 @@ QWidget* MainWindow::buildWorkOrderPage() {
 
   form->addRow(tr("Vehicle"), vehicleSelect_);
   form->addRow(tr("Mechanic"), techSelect_);
+  form->addRow(tr("Odometer"), orderMileage_);
   form->addRow(tr("Service ID"), serviceId_);
   form->addRow(tr("Service Name"), serviceName_);
   form->addRow(tr("Labor Hours"), laborHours_);
@@ -210,17 +303,36 @@ QWidget* MainWindow::buildSummaryPage() {
   auto* layout = new QVBoxLayout(page);
   summaryLabel_ = new QLabel(tr("Summary"), page);
   layout->addWidget(summaryLabel_);
+  auto* exportBtn = new QPushButton(tr("Export Report..."), page);
+  connect(exportBtn, &QPushButton::clicked, this, &MainWindow::exportReport);
+  layout->addWidget(exportBtn);
+  auto* payrollBtn = new QPushButton(tr("Run Payroll (this month)..."), page);
+  connect(payrollBtn, &QPushButton::clicked, this, &MainWindow::runPayroll);
+  layout->addWidget(payrollBtn);
   layout->addWidget(new QLabel(tr("Status Overview"), page));
-  statusTable_ = new QTableWidget(0, 3, page);
-  statusTable_->setHorizontalHeaderLabels({tr("Status"), tr("Count"), tr("Work Orders")});
+  statusTable_ = new QTableWidget(0, 2, page);
+  statusTable_->setHorizontalHeaderLabels({tr("Status"), tr("Count")});
   statusTable_->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
   layout->addWidget(statusTable_);
 
   layout->addWidget(new QLabel(tr("Inventory Snapshot"), page));
-  inventoryTable_ = new QTableWidget(0, 4, page);
-  inventoryTable_->setHorizontalHeaderLabels({tr("Part ID"), tr("Name"), tr("Stock"), tr("Capacity")});
+  inventoryTable_ = new QTableView(page);
+  inventoryModel_ = new InventoryTableModel(store_.parts, this);
+  inventoryTable_->setModel(inventoryModel_);
   inventoryTable_->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
   layout->addWidget(inventoryTable_);
+
+  layout->addWidget(new QLabel(tr("Top 5"), page));
+  leadersTable_ = new QTableWidget(0, 4, page);
+  leadersTable_->setHorizontalHeaderLabels({tr("Rank"), tr("Parts Used"), tr("Customers by Revenue"), tr("Busiest Mechanics")});
+  leadersTable_->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+  layout->addWidget(leadersTable_);
+
+  layout->addWidget(new QLabel(tr("Stage Latency (minutes)"), page));
+  latencyTable_ = new QTableWidget(0, 6, page);
+  latencyTable_->setHorizontalHeaderLabels({tr("Stage"), tr("Breakdown"), tr("Count"), tr("p50"), tr("p90"), tr("p99")});
+  latencyTable_->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+  layout->addWidget(latencyTable_);
   return page;
 }
 
@@ -242,66 +354,26 @@ QWidget* MainWindow::buildHelpPage() {
 }
 
 void MainWindow::populateCustomers() {
+  TRACE_SCOPE("gui.populateCustomers");
   customerList_->clear();
-  for (const auto& c : store_.customers) {
-    auto* item = new QListWidgetItem(QString::fromStdString(c.name + " (" + c.id + ")"));
-    item->setData(Qt::UserRole, QString::fromStdString(c.id));
-    customerList_->addItem(item);
-  }
+  for (const auto& c : store_.customers) appendCustomer(c);
   if (!store_.customers.empty()) {
     customerList_->setCurrentRow(0);
     refreshVehicleList();
   }
 }
 
-void MainWindow::populateVehiclesForCustomer(const std::string& customerId) {
-  vehicleTable_->setRowCount(0);
-  for (const auto& v : store_.vehicles) {
-    if (v.ownerId != customerId) continue;
-    int row = vehicleTable_->rowCount();
-    vehicleTable_->insertRow(row);
-    vehicleTable_->setItem(row, 0, new QTableWidgetItem(QString::fromStdString(v.vin)));
-    vehicleTable_->setItem(row, 1, new QTableWidgetItem(QString::fromStdString(v.plate)));
-    vehicleTable_->setItem(row, 2, new QTableWidgetItem(QString::fromStdString(v.brand)));
-    vehicleTable_->setItem(row, 3, new QTableWidgetItem(QString::fromStdString(v.model)));
-    vehicleTable_->setItem(row, 4, new QTableWidgetItem(QString::number(v.year)));
-  }
-}
-
-void MainWindow::populateTechnicians() {
-  technicianTable_->setRowCount(0);
-  for (const auto& t : store_.technicians) {
-    int row = technicianTable_->rowCount();
-    technicianTable_->insertRow(row);
-    technicianTable_->setItem(row, 0, new QTableWidgetItem(QString::fromStdString(t.id)));
-    technicianTable_->setItem(row, 1, new QTableWidgetItem(QString::fromStdString(t.name)));
-    technicianTable_->setItem(row, 2, new QTableWidgetItem(QString::number(t.hourlyRate)));
-    technicianTable_->setItem(row, 3, new QTableWidgetItem(joinIds(t.assignedWorkOrders)));
-  }
-}
-
-void MainWindow::populateWorkOrders() {
-  workOrderTable_->setRowCount(0);
-  for (const auto& w : store_.workOrders) {
-    int row = workOrderTable_->rowCount();
-    workOrderTable_->insertRow(row);
-    workOrderTable_->setItem(row, 0, new QTableWidgetItem(QString::fromStdString(w.id)));
-    workOrderTable_->setItem(row, 1, new QTableWidgetItem(QString::fromStdString(w.vehicle.plate)));
-    workOrderTable_->setItem(row, 2, new QTableWidgetItem(QString::fromStdString(w.customer.name)));
-    workOrderTable_->setItem(row, 3, new QTableWidgetItem(QString::fromStdString(w.tech.name)));
-    workOrderTable_->setItem(row, 4, new QTableWidgetItem(statusToText(w.status)));
-    workOrderTable_->setItem(row, 5, new QTableWidgetItem(QString::number(w.previewTotal())));
-    workOrderTable_->setItem(row, 6, new QTableWidgetItem(QString::fromStdString(w.detectionNote)));
-  }
+void MainWindow::appendCustomer(const Customer& c) {
+  auto* item = new QListWidgetItem(QString::fromStdString(c.name + " (" + c.id + ")"));
+  item->setData(Qt::UserRole, QString::fromStdString(c.id));
+  customerList_->addItem(item);
 }
 
 void MainWindow::populateSelectors() {
+  TRACE_SCOPE("gui.populateSelectors");
   vehicleSelect_->clear();
   for (const auto& v : store_.vehicles) {
-    bool alreadyHasOrder = std::any_of(store_.workOrders.begin(), store_.workOrders.end(), [&](const WorkOrder& w){
-      return w.vehicle.vin == v.vin;
-    });
-    if (alreadyHasOrder) continue; // enforce one work order per vehicle
+    if (workshop_.vehicleHasOrder(v.vin)) continue; // enforce one work order per vehicle
     QString label = QString::fromStdString(v.plate + " (" + v.vin + ")");
     vehicleSelect_->addItem(label, QString::fromStdString(v.vin));
   }
@@ -313,16 +385,15 @@ void MainWindow::populateSelectors() {
 }
 
 void MainWindow::updateSummary() {
-  refreshInventorySnapshot();
+  TRACE_SCOPE("gui.updateSummary");
   statusTable_->setRowCount(0);
-  auto report = ReportService::summary(store_.workOrders, store_.parts);
+  // Counts only; listing every order id would cost O(orders) strings per refresh
+  const auto totals = ReportEngine::totals(store_.orderColumns);
   auto insertRow = [&](const QString& name, WOStatus status) {
-    const auto& ids = report.statusBuckets[status];
     int row = statusTable_->rowCount();
     statusTable_->insertRow(row);
     statusTable_->setItem(row, 0, new QTableWidgetItem(name));
-    statusTable_->setItem(row, 1, new QTableWidgetItem(QString::number(ids.size())));
-    statusTable_->setItem(row, 2, new QTableWidgetItem(joinIds(ids)));
+    statusTable_->setItem(row, 1, new QTableWidgetItem(QString::number(totals.statusCounts[static_cast<std::size_t>(status)])));
   };
   insertRow(tr("Draft"), WOStatus::Draft);
   insertRow(tr("Assigned"), WOStatus::Assigned);
@@ -331,56 +402,95 @@ void MainWindow::updateSummary() {
   insertRow(tr("Paid"), WOStatus::Paid);
   insertRow(tr("Cancelled"), WOStatus::Cancelled);
 
-  summaryLabel_->setText(tr("Paid Orders: %1, Turnover: %2").arg(report.paidCount).arg(report.turnover));
+  // Archived orders are summarized from the archive index; segments stay on disk
+  QStringList months;
+  for (const auto& s : archive_.segments()) months << QString::fromStdString(s.month);
+  int row = statusTable_->rowCount();
+  statusTable_->insertRow(row);
+  statusTable_->setItem(row, 0, new QTableWidgetItem(tr("Archived")));
+  auto* archived = new QTableWidgetItem(QString::number(archive_.archivedCount()));
+  archived->setToolTip(months.join(", "));
+  statusTable_->setItem(row, 1, archived);
+
+  const int today = TurnoverRollup::dayOf(QDateTime::currentMSecsSinceEpoch());
+  const int weekStart = TurnoverRollup::firstDayOfWeek(TurnoverRollup::weekOf(today));
+  const int monthStart = TurnoverRollup::firstDayOfMonth(TurnoverRollup::monthOf(today));
+  auto day = ReportService::turnover(store_.turnoverRollup, today, today);
+  auto week = ReportService::turnover(store_.turnoverRollup, weekStart, today);
+  auto month = ReportService::turnover(store_.turnoverRollup, monthStart, today);
+  summaryLabel_->setText(tr("Paid Orders: %1, Turnover: %2\nToday: %3 | This week: %4 | This month: %5")
+                         .arg(totals.paidCount + archive_.archivedPaidCount())
+                         .arg(static_cast<double>(totals.turnoverCents) / 100 + archive_.archivedTurnover())
+                         .arg(day.total).arg(week.total).arg(month.total));
+
+  leadersTable_->setRowCount(0);
+  const auto parts = ReportService::topParts(store_.topN, 5);
+  const auto customers = ReportService::topCustomers(store_.topN, 5);
+  const auto mechanics = ReportService::topTechnicians(store_.topN, 5);
+  auto cell = [](const std::vector<RankedEntry>& list, std::size_t i, const QString& unit) {
+    if (i >= list.size()) return new QTableWidgetItem();
+    return new QTableWidgetItem(QString::fromStdString(list[i].key) + " (" + QString::number(list[i].value) + unit + ")");
+  };
+  const std::size_t ranks = std::max({parts.size(), customers.size(), mechanics.size()});
+  for (std::size_t i = 0; i < ranks; ++i) {
+    int row = leadersTable_->rowCount();
+    leadersTable_->insertRow(row);
+    leadersTable_->setItem(row, 0, new QTableWidgetItem(QString::number(i + 1)));
+    leadersTable_->setItem(row, 1, cell(parts, i, tr(" pcs")));
+    leadersTable_->setItem(row, 2, cell(customers, i, QString()));
+    leadersTable_->setItem(row, 3, cell(mechanics, i, tr(" orders")));
+  }
 
-  inventoryTable_->setRowCount(0);
-  for (const auto& p : report.inventory) {
-    int row = inventoryTable_->rowCount();
-    inventoryTable_->insertRow(row);
-    inventoryTable_->setItem(row, 0, new QTableWidgetItem(QString::fromStdString(p.id)));
-    inventoryTable_->setItem(row, 1, new QTableWidgetItem(QString::fromStdString(p.name)));
-    inventoryTable_->setItem(row, 2, new QTableWidgetItem(QString::number(p.stock)));
-    inventoryTable_->setItem(row, 3, new QTableWidgetItem(QString::number(p.capacity)));
+  latencyTable_->setRowCount(0);
+  auto minutes = [](std::int64_t ms) { return QString::number(ms / 60000.0, 'f', 1); };
+  auto insertLatency = [&](Stage stage, const QString& who, const LatencyHistogram& h) {
+    if (h.count() == 0) return;
+    int row = latencyTable_->rowCount();
+    latencyTable_->insertRow(row);
+    latencyTable_->setItem(row, 0, new QTableWidgetItem(tr(stageName(stage))));
+    latencyTable_->setItem(row, 1, new QTableWidgetItem(who));
+    latencyTable_->setItem(row, 2, new QTableWidgetItem(QString::number(h.count())));
+    latencyTable_->setItem(row, 3, new QTableWidgetItem(minutes(h.percentile(0.5))));
+    latencyTable_->setItem(row, 4, new QTableWidgetItem(minutes(h.percentile(0.9))));
+    latencyTable_->setItem(row, 5, new QTableWidgetItem(minutes(h.percentile(0.99))));
+  };
+  for (auto stage : kStages) insertLatency(stage, tr("All"), store_.lifecycleStats.overall(stage));
+  for (const auto& [key, h] : store_.lifecycleStats.byTechnician()) {
+    insertLatency(key.first, tr("Mechanic %1").arg(QString::fromStdString(key.second)), h);
+  }
+  for (const auto& [key, h] : store_.lifecycleStats.byService()) {
+    insertLatency(key.first, tr("Service %1").arg(QString::fromStdString(key.second)), h);
   }
 }
 
 void MainWindow::refreshInventorySnapshot() {
-  store_.parts = storeHouse_.snapshot();
-}
-
-void MainWindow::attachOrderToTech(const std::string& techId, const std::string& woId) {
-  auto techIt = std::find_if(store_.technicians.begin(), store_.technicians.end(), [&](const Technician& t){ return t.id == techId; });
-  if (techIt == store_.technicians.end()) return;
-  auto& list = techIt->assignedWorkOrders;
-  if (std::find(list.begin(), list.end(), woId) == list.end()) list.push_back(woId);
-}
-
-void MainWindow::detachOrderFromAllTechs(const std::string& woId) {
-  for (auto& t : store_.technicians) {
-    auto& list = t.assignedWorkOrders;
-    list.erase(std::remove(list.begin(), list.end(), woId), list.end());
-  }
+  // The constructor may persist before the views exist
+  if (inventoryModel_) inventoryModel_->replace(storeHouse_.snapshot());
+  else store_.parts = storeHouse_.snapshot();
 }
 
 void MainWindow::persist() {
+  TRACE_SCOPE("gui.persist");
   refreshInventorySnapshot();
   DataStorePersistence::save(store_, dataPath_.toStdString());
+  dirty_ = false;
+}
+
+void MainWindow::saveIfDirty() {
+  if (dirty_) persist();
 }
 
 void MainWindow::addCustomer() {
   Customer c;
-  c.id = generateId("C", static_cast<int>(store_.customers.size() + 1));
   c.name = customerName_->text().toStdString();
   c.phone = customerPhone_->text().toStdString();
   c.level = customerLevel_->currentIndex();
-  if (c.name.empty()) {
-    QMessageBox::warning(this, tr("Validation"), tr("Customer name is required"));
+  try {
+    workshop_.addCustomer(c);
+  } catch (const std::exception& e) {
+    QMessageBox::warning(this, tr("Validation"), e.what());
     return;
   }
-  store_.customers.push_back(c);
-  populateCustomers();
-  populateSelectors();
-  persist();
   customerName_->clear();
   customerPhone_->clear();
 }
@@ -398,14 +508,13 @@ void MainWindow::addVehicle() {
   v.brand = brand_->text().toStdString();
   v.model = model_->text().toStdString();
   v.year = year_->value();
-  if (v.vin.empty() || v.plate.empty()) {
-    QMessageBox::warning(this, tr("Validation"), tr("VIN and Plate are required"));
+  v.mileage = mileage_->value();
+  try {
+    workshop_.addVehicle(v);
+  } catch (const std::exception& e) {
+    QMessageBox::warning(this, tr("Validation"), e.what());
     return;
   }
-  store_.vehicles.push_back(v);
-  refreshVehicleList();
-  populateSelectors();
-  persist();
   vin_->clear(); plate_->clear(); brand_->clear(); model_->clear();
 }
 
@@ -414,14 +523,12 @@ void MainWindow::addTechnician() {
   t.id = techId_->text().toStdString();
   t.name = techName_->text().toStdString();
   t.hourlyRate = hourlyRate_->value();
-  if (t.id.empty() || t.name.empty()) {
-    QMessageBox::warning(this, tr("Validation"), tr("ID and Name required"));
+  try {
+    workshop_.addTechnician(t);
+  } catch (const std::exception& e) {
+    QMessageBox::warning(this, tr("Validation"), e.what());
     return;
   }
-  store_.technicians.push_back(t);
-  populateTechnicians();
-  populateSelectors();
-  persist();
   techId_->clear();
   techName_->clear();
 }
@@ -431,165 +538,264 @@ void MainWindow::createWorkOrder() {
     QMessageBox::warning(this, tr("Validation"), tr("Vehicle and mechanic are required"));
     return;
   }
-  QString vin = vehicleSelect_->currentData().toString();
-  auto vehicleIt = std::find_if(store_.vehicles.begin(), store_.vehicles.end(), [&](const Vehicle& v){ return QString::fromStdString(v.vin) == vin; });
-  if (vehicleIt == store_.vehicles.end()) return;
-
-  bool used = std::any_of(store_.workOrders.begin(), store_.workOrders.end(), [&](const WorkOrder& w){ return w.vehicle.vin == vehicleIt->vin; });
-  if (used) {
-    QMessageBox::warning(this, tr("Validation"), tr("This vehicle already has a work order"));
-    return;
-  }
-
-  QString techId = techSelect_->currentData().toString();
-  auto techIt = std::find_if(store_.technicians.begin(), store_.technicians.end(), [&](const Technician& t){ return QString::fromStdString(t.id) == techId; });
-  if (techIt == store_.technicians.end()) return;
-
-  auto customerIt = std::find_if(store_.customers.begin(), store_.customers.end(), [&](const Customer& c){ return c.id == vehicleIt->ownerId; });
-  if (customerIt == store_.customers.end()) {
-    QMessageBox::warning(this, tr("Validation"), tr("Vehicle owner not found"));
-    return;
-  }
-
-  WorkOrder w;
-  w.id = generateId("WO", static_cast<int>(store_.workOrders.size() + 1));
-  w.vehicle = *vehicleIt;
-  w.customer = *customerIt;
-  w.advisor.id = "SA001"; w.advisor.name = "Advisor"; // simple demo advisor
-
-  auto detection = MaintenanceDetector::detect(*vehicleIt, storeHouse_.snapshot());
-  w.items.insert(w.items.end(), detection.items.begin(), detection.items.end());
-  w.detectionNote = detection.note;
-  if (!detection.items.empty()) {
-    QStringList detectedLines;
-    for (const auto& it : detection.items) {
-      QStringList partLabels;
-      for (const auto& pr : it.parts) {
-        partLabels << QString::fromStdString(pr.first.name + " x" + std::to_string(pr.second));
-      }
-      auto partSummary = partLabels.isEmpty() ? tr("No parts required") : partLabels.join(", ");
-      detectedLines << QString::fromStdString(it.item.name) + " (" + partSummary + ")";
-    }
-    QMessageBox::information(this, tr("Detected Service"),
-                             tr("Proposed jobs based on vehicle %1:\n%2")
-                             .arg(QString::fromStdString(vehicleIt->plate))
-                             .arg(detectedLines.join("\n")));
-  }
+  const auto vin = vehicleSelect_->currentData().toString().toStdString();
+  const auto techId = techSelect_->currentData().toString().toStdString();
 
+  std::vector<WOItem> manual;
   ServiceItem si;
   si.id = serviceId_->text().toStdString();
   si.name = serviceName_->text().toStdString();
   si.laborHours = laborHours_->value();
   si.basePrice = basePrice_->value();
-
   if (!si.id.empty()) {
     WOItem item;
     item.item = si;
     item.laborHoursOverride = laborOverride_->value();
     item.autoDetected = false;
-    w.items.push_back(item);
+    manual.push_back(item);
   }
 
+  std::size_t row = 0;
   try {
-    w.assign(*techIt);
+    row = workshop_.createOrder(vin, techId, orderMileage_->value(), manual);
   } catch (const std::exception& e) {
-    QMessageBox::critical(this, tr("Error"), e.what());
+    QMessageBox::warning(this, tr("Cannot create work order"), e.what());
     return;
   }
 
-  attachOrderToTech(techIt->id, w.id);
-  store_.workOrders.push_back(w);
-  populateWorkOrders();
-  populateSelectors();
-  updateSummary();
-  persist();
+  const auto& w = store_.workOrders[row];
+  QStringList detectedLines;
+  for (const auto& it : w.items) {
+    if (!it.autoDetected) continue;
+    QStringList partLabels;
+    for (const auto& pr : it.parts) {
+      partLabels << QString::fromStdString(pr.first.name + " x" + std::to_string(pr.second));
+    }
+    auto partSummary = partLabels.isEmpty() ? tr("No parts required") : partLabels.join(", ");
+    detectedLines << QString::fromStdString(it.item.name) + " (" + partSummary + ")";
+  }
+  if (!detectedLines.isEmpty()) {
+    QMessageBox::information(this, tr("Detected Service"),
+                             tr("Proposed jobs based on vehicle %1:\n%2")
+                             .arg(QString::fromStdString(w.vehicle.plate))
+                             .arg(detectedLines.join("\n")));
+  }
   serviceId_->clear();
   serviceName_->clear();
   laborHours_->setValue(0);
   basePrice_->setValue(0);
   laborOverride_->setValue(-1);
+  orderMileage_->setValue(0);
 }
 
 int MainWindow::currentWorkOrderRow() const {
-  return workOrderTable_->currentRow();
+  return workOrderTable_->currentIndex().row();
 }
 
 void MainWindow::assignWorkOrder() {
   int row = currentWorkOrderRow();
-  if (row < 0 || row >= static_cast<int>(store_.workOrders.size())) return;
-  auto techId = techSelect_->currentData().toString().toStdString();
-  auto techIt = std::find_if(store_.technicians.begin(), store_.technicians.end(), [&](const Technician& t){ return t.id == techId; });
-  if (techIt == store_.technicians.end()) return;
+  if (row < 0) return;
   try {
-    detachOrderFromAllTechs(store_.workOrders[row].id);
-    store_.workOrders[row].assign(*techIt);
-    attachOrderToTech(techIt->id, store_.workOrders[row].id);
+    workshop_.assign(row, techSelect_->currentData().toString().toStdString());
   } catch (const std::exception& e) {
     QMessageBox::warning(this, tr("Cannot assign"), e.what());
   }
-  populateWorkOrders();
-  updateSummary();
-  persist();
 }
 
 void MainWindow::startWorkOrder() {
   int row = currentWorkOrderRow();
-  if (row < 0 || row >= static_cast<int>(store_.workOrders.size())) return;
+  if (row < 0) return;
   try {
-    store_.workOrders[row].start();
+    workshop_.start(row);
   } catch (const std::exception& e) {
     QMessageBox::warning(this, tr("Cannot start"), e.what());
   }
-  populateWorkOrders();
-  updateSummary();
-  persist();
 }
 
 void MainWindow::completeWorkOrder() {
   int row = currentWorkOrderRow();
-  if (row < 0 || row >= static_cast<int>(store_.workOrders.size())) return;
+  if (row < 0) return;
   try {
-    store_.workOrders[row].complete();
+    workshop_.complete(row);
   } catch (const std::exception& e) {
     QMessageBox::warning(this, tr("Cannot complete"), e.what());
   }
-  populateWorkOrders();
-  updateSummary();
-  persist();
 }
 
 void MainWindow::settleWorkOrder() {
   int row = currentWorkOrderRow();
-  if (row < 0 || row >= static_cast<int>(store_.workOrders.size())) return;
+  if (row < 0) return;
   try {
-    double total = store_.workOrders[row].settle();
-    bool consumed = storeHouse_.consumeForOrder(store_.workOrders[row]);
-    auto alerts = storeHouse_.takeAlerts();
-    refreshInventorySnapshot();
+    auto result = workshop_.settle(row);
 
-    QString message = tr("Total: %1").arg(total);
-    if (!consumed) {
+    QString message = tr("Total: %1").arg(result.total);
+    if (!result.partsConsumed) {
       message += tr("\nUnable to consume all parts. Check inventory levels.");
     }
-    if (!alerts.empty()) {
+    if (!result.alerts.empty()) {
       QStringList alertLines;
-      for (const auto& a : alerts) alertLines << QString::fromStdString(a);
+      for (const auto& a : result.alerts) alertLines << QString::fromStdString(a);
       message += tr("\nAlerts:\n%1").arg(alertLines.join("\n"));
     }
     QMessageBox::information(this, tr("Settled"), message);
   } catch (const std::exception& e) {
     QMessageBox::warning(this, tr("Cannot settle"), e.what());
   }
-  populateWorkOrders();
-  updateSummary();
-  persist();
+}
+
+void MainWindow::exportReport() {
+  auto path = QFileDialog::getSaveFileName(this, tr("Export Report"), QString(), tr("CSV (*.csv);;JSON (*.json)"));
+  if (path.isEmpty()) return;
+  refreshInventorySnapshot();
+  if (!ReportExporter::exportTo(path.toStdString(), store_, &archive_)) {
+    QMessageBox::warning(this, tr("Export failed"), tr("Could not write %1").arg(path));
+    return;
+  }
+  QMessageBox::information(this, tr("Exported"), tr("Report written to %1").arg(path));
+}
+
+void MainWindow::runPayroll() {
+  const int today = TurnoverRollup::dayOf(QDateTime::currentMSecsSinceEpoch());
+  const int monthStart = TurnoverRollup::firstDayOfMonth(TurnoverRollup::monthOf(today));
+  auto suggested = QString::fromStdString(PayrollEngine::fileNameFor(monthStart, today));
+  auto path = QFileDialog::getSaveFileName(this, tr("Save Payroll"), suggested, tr("CSV (*.csv)"));
+  if (path.isEmpty()) return;
+  auto run = PayrollEngine::run(store_, monthStart, today, &archive_);
+  if (!PayrollEngine::writeCsv(run, path.toStdString())) {
+    QMessageBox::warning(this, tr("Payroll failed"), tr("Could not write %1").arg(path));
+    return;
+  }
+  // Changed hours are published, so the table, the save timer and followers pick them up
+  for (const auto& line : run.lines) {
+    if (line.role == PayRole::Technician) workshop_.setHoursWorked(line.employeeId, line.hours);
+  }
+  QMessageBox::information(this, tr("Payroll"), tr("%1 employees, total %2, written to %3")
+                           .arg(run.lines.size()).arg(run.total).arg(path));
+}
+
+void MainWindow::onChange(const ChangeEvent& event) {
+  switch (event.entity) {
+    case Entity::Customer:
+      // The search index and the list only ever gain entries
+      if (event.change != Change::Added) break;
+      search_.addCustomer(store_.customers[event.row]);
+      pending_.addedCustomers.push_back(event.row);
+      break;
+    case Entity::Vehicle:
+      if (event.change == Change::Added) {
+        search_.addVehicle(store_.vehicles[event.row]);
+        pending_.addedVehicles.push_back(event.row);
+        pending_.selectors = true;
+      } else {
+        pending_.vehicleRows.insert(event.row);
+      }
+      break;
+    case Entity::Technician:
+      if (event.change == Change::Added) pending_.selectors = true;
+      else pending_.technicianRows.insert(event.row);
+      break;
+    case Entity::WorkOrder:
+      // A new order takes its vehicle out of the selector; a paid one puts it back
+      if (event.change == Change::Added || isClosed(store_.workOrders[event.row].status)) pending_.selectors = true;
+      if (event.change != Change::Added) pending_.workOrderRows.insert(event.row);
+      pending_.summary = true;
+      break;
+    case Entity::Part:
+      pending_.partRows.insert(event.row);
+      pending_.summary = true;
+      break;
+  }
+  if (pending_.scheduled) return;
+  pending_.scheduled = true;
+  QTimer::singleShot(0, this, &MainWindow::flushChanges);
+}
+
+void MainWindow::flushChanges() {
+  TRACE_SCOPE("gui.flushChanges");
+  PendingRefresh pending = std::move(pending_);
+  pending_ = PendingRefresh{};
+
+  // Pages not opened yet pick everything up when they are
+  if (!stale(workOrderPage_)) {
+    workOrderModel_->showRows(static_cast<int>(store_.workOrders.size()));
+    for (auto row : pending.workOrderRows) workOrderModel_->rowChanged(static_cast<int>(row));
+    if (pending.selectors) populateSelectors();
+  }
+  if (!stale(technicianPage_)) {
+    technicianModel_->showRows(static_cast<int>(store_.technicians.size()));
+    for (auto row : pending.technicianRows) technicianModel_->rowChanged(static_cast<int>(row));
+  }
+  for (auto row : pending.partRows) inventoryModel_->rowChanged(static_cast<int>(row));
+  for (auto index : pending.addedVehicles) vehicleModel_->vehicleAdded(index);
+  for (auto index : pending.vehicleRows) vehicleModel_->vehicleChanged(index);
+  for (auto row : pending.addedCustomers) appendCustomer(store_.customers[row]);
+  if (!pending.addedCustomers.empty() && !customerList_->currentItem()) {
+    customerList_->setCurrentRow(0);
+    refreshVehicleList();
+  }
+  if (pending.summary && !stale(summaryPage_)) updateSummary();
+  dirty_ = true;
+}
+
+// The first press starts tracing; later presses write what was recorded
+void MainWindow::dumpTrace() {
+  if (!Tracer::enabled()) {
+    Tracer::setEnabled(true);
+    statusBar()->showMessage(tr("Tracing started; press Ctrl+Shift+T again to save"), 5000);
+    return;
+  }
+  const auto path = Tracer::outputPath();
+  if (Tracer::dump(path)) statusBar()->showMessage(tr("Trace written to %1").arg(QString::fromStdString(path)), 5000);
+  else QMessageBox::warning(this, tr("Trace"), tr("Cannot write %1").arg(QString::fromStdString(path)));
+}
+
+void MainWindow::runSearch(const QString& text) {
+  searchResults_->clear();
+  for (const auto& hit : search_.search(text.trimmed().toStdString())) {
+    QString kind = hit.kind == SearchKind::Vehicle ? tr("Vehicle")
+                 : hit.kind == SearchKind::Customer ? tr("Customer") : tr("Part");
+    auto* item = new QListWidgetItem(kind + ": " + QString::fromStdString(hit.label));
+    item->setData(Qt::UserRole, QString::fromStdString(hit.id));
+    item->setData(Qt::UserRole + 1, static_cast<int>(hit.kind));
+    searchResults_->addItem(item);
+  }
+}
+
+void MainWindow::openSearchHit(QListWidgetItem* item) {
+  if (!item) return;
+  const auto id = item->data(Qt::UserRole).toString().toStdString();
+  switch (static_cast<SearchKind>(item->data(Qt::UserRole + 1).toInt())) {
+    case SearchKind::Vehicle: {
+      int pick = vehicleSelect_->findData(QString::fromStdString(id));
+      if (pick >= 0) {
+        vehicleSelect_->setCurrentIndex(pick);
+        return;
+      }
+      // Vehicles with an order are not in the selector; show the order instead
+      if (auto row = workshop_.findOrder(id)) workOrderTable_->selectRow(static_cast<int>(*row));
+      return;
+    }
+    case SearchKind::Customer: {
+      auto it = std::find_if(store_.customers.begin(), store_.customers.end(), [&](const Customer& c){ return c.id == id; });
+      if (it == store_.customers.end()) return;
+      tabs_->setCurrentWidget(customerList_->parentWidget());
+      customerList_->setCurrentRow(static_cast<int>(it - store_.customers.begin()));
+      return;
+    }
+    case SearchKind::Part: {
+      auto it = std::find_if(store_.parts.begin(), store_.parts.end(), [&](const Part& p){ return p.id == id; });
+      if (it == store_.parts.end()) return;
+      tabs_->setCurrentWidget(inventoryTable_->parentWidget());
+      inventoryTable_->selectRow(static_cast<int>(it - store_.parts.begin()));
+      return;
+    }
+  }
 }
 
 void MainWindow::refreshVehicleList() {
   auto* item = customerList_->currentItem();
   if (!item) return;
-  std::string id = item->data(Qt::UserRole).toString().toStdString();
-  populateVehiclesForCustomer(id);
+  vehicleModel_->setOwner(item->data(Qt::UserRole).toString().toStdString());
 }
 
 #include "ui/gui.moc"
@@ -4,6 +4,7 @@
 #include <QTabWidget>
 #include <QListWidget>
 #include <QTableWidget>
+#include <QTableView>
 #include <QLineEdit>
 #include <QComboBox>
 #include <QSpinBox>
@@ -11,15 +12,30 @@
 #include <QPushButton>
 #include <QTextEdit>
 #include <QDoubleSpinBox>
+#include <QProgressBar>
+#include <QThread>
+#include <QTimer>
+#include <memory>
+#include <set>
 #include <vector>
 #include "domain/work_order.hpp"
 #include "domain/data_store.hpp"
+#include "domain/change_bus.hpp"
+#include "domain/search_index.hpp"
 #include "inventory/store_house.hpp"
+#include "persistence/change_log.hpp"
+#include "persistence/work_order_archive.hpp"
+#include "service/workshop_service.hpp"
+#include "ui/table_models.hpp"
 
-class MainWindow : public QMainWindow {
+class MainWindow : public QMainWindow, public ChangeObserver {
   Q_OBJECT
 public:
-  explicit MainWindow(DataStore store, const QString& dataPath, QWidget* parent = nullptr);
+  // Shows an empty, disabled window and loads the store on a worker thread.
+  explicit MainWindow(const QString& dataPath, QWidget* parent = nullptr);
+  ~MainWindow() override;
+
+  void onChange(const ChangeEvent& event) override;
 
 private slots:
   void addCustomer();
@@ -31,36 +47,81 @@ private slots:
   void completeWorkOrder();
   void settleWorkOrder();
   void refreshVehicleList();
+  void exportReport();
+  void runPayroll();
+  void runSearch(const QString& text);
+  void openSearchHit(QListWidgetItem* item);
+  void fillPageOnFirstOpen(int index);
+  void dumpTrace();
 
 private:
   DataStore store_;
   StoreHouse storeHouse_{};
   QString dataPath_;
+  WorkOrderArchive archive_;
+  ChangeBus changes_;
+  SearchIndex search_;
+  WorkshopService workshop_{store_, storeHouse_};
+  ChangeLogWriter changeLog_{store_, ChangeLogWriter::pathFor(dataPath_.toStdString())};
+
+  // Startup: the worker builds a LoadedState, handed over on the GUI thread
+  struct LoadedState;
+  std::unique_ptr<QThread> loader_;
+  QProgressBar* loadProgress_{};
+  QWidget *workOrderPage_{}, *technicianPage_{}, *summaryPage_{};
+  std::set<QWidget*> stalePages_; // filled the first time their tab opens
+
+  // Changes published since the last flush; views are brought up to date
+  // once per event-loop tick, however many events arrived.
+  struct PendingRefresh {
+    std::set<std::size_t> workOrderRows;
+    std::set<std::size_t> technicianRows;
+    std::set<std::size_t> partRows;
+    std::vector<std::size_t> addedVehicles;
+    std::set<std::size_t> vehicleRows;
+    std::vector<std::size_t> addedCustomers;
+    bool selectors{false};
+    bool summary{false};
+    bool scheduled{false};
+  };
+  PendingRefresh pending_;
+  // The store is saved at most once per interval rather than per change
+  QTimer saveTimer_;
+  bool dirty_{false};
   QTabWidget* tabs_{};
 
   // Customer page widgets
   QListWidget* customerList_{};
-  QTableWidget* vehicleTable_{};
+  QTableView* vehicleTable_{};
+  VehicleTableModel* vehicleModel_{};
   QLineEdit *customerName_{}, *customerPhone_{};
   QComboBox* customerLevel_{};
   QLineEdit *vin_{}, *plate_{}, *brand_{}, *model_{};
-  QSpinBox* year_{};
+  QSpinBox *year_{}, *mileage_{};
 
   // Mechanic page widgets
-  QTableWidget* technicianTable_{};
+  QTableView* technicianTable_{};
+  TechnicianTableModel* technicianModel_{};
   QLineEdit *techId_{}, *techName_{};
   QSpinBox* hourlyRate_{};
 
   // Work order page widgets
-  QTableWidget* workOrderTable_{};
+  QLineEdit* searchBox_{};
+  QListWidget* searchResults_{};
+  QTableView* workOrderTable_{};
+  WorkOrderTableModel* workOrderModel_{};
   QComboBox *vehicleSelect_{}, *techSelect_{};
+  QSpinBox* orderMileage_{};
   QLineEdit *serviceId_{}, *serviceName_{};
   QDoubleSpinBox *laborHours_{}, *basePrice_{}, *laborOverride_{};
 
   // Summary page widgets
   QLabel *summaryLabel_{};
   QTableWidget* statusTable_{};
-  QTableWidget* inventoryTable_{};
+  QTableView* inventoryTable_{};
+  InventoryTableModel* inventoryModel_{};
+  QTableWidget* latencyTable_{};
+  QTableWidget* leadersTable_{};
 
   void setupUI();
   QWidget* buildCustomerPage();
@@ -70,15 +131,16 @@ private:
   QWidget* buildHelpPage();
 
   void populateCustomers();
-  void populateVehiclesForCustomer(const std::string& customerId);
-  void populateTechnicians();
-  void populateWorkOrders();
+  void appendCustomer(const Customer& c);
   void populateSelectors();
   void updateSummary();
   void refreshInventorySnapshot();
   int currentWorkOrderRow() const;
-  void attachOrderToTech(const std::string& techId, const std::string& woId);
-  void detachOrderFromAllTechs(const std::string& woId);
   void persist();
+  void saveIfDirty();
+  void flushChanges();
+  void startLoading();
+  void finishLoading(const std::shared_ptr<LoadedState>& state);
+  bool stale(QWidget* page) const { return stalePages_.count(page) > 0; }
 };
 
@@ -0,0 +1,196 @@
+#include "ui/table_models.hpp"
+#include "trace/tracer.hpp"
+
+#include <algorithm>
+
+QString statusToText(WOStatus st) {
+  switch (st) {
+    case WOStatus::Draft: return "Draft";
+    case WOStatus::Assigned: return "Assigned";
+    case WOStatus::InProgress: return "In Progress";
+    case WOStatus::Completed: return "Completed";
+    case WOStatus::Paid: return "Paid";
+    case WOStatus::Cancelled: return "Cancelled";
+  }
+  return "Unknown";
+}
+
+QString joinIds(const std::vector<std::string>& ids) {
+  QStringList list;
+  for (const auto& id : ids) list << QString::fromStdString(id);
+  return list.join(", ");
+}
+
+QString joinIds(const std::vector<IdHandle>& ids, const IdTable& table) {
+  QStringList list;
+  for (auto id : ids) list << QString::fromStdString(table.name(id));
+  return list.join(", ");
+}
+
+StoreTableModel::StoreTableModel(QStringList headers, int rows, QObject* parent)
+    : QAbstractTableModel(parent), headers_(std::move(headers)), shown_(rows) {}
+
+int StoreTableModel::rowCount(const QModelIndex& parent) const {
+  return parent.isValid() ? 0 : shown_;
+}
+
+int StoreTableModel::columnCount(const QModelIndex& parent) const {
+  return parent.isValid() ? 0 : static_cast<int>(headers_.size());
+}
+
+QVariant StoreTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+  if (role != Qt::DisplayRole) return QVariant();
+  if (orientation == Qt::Horizontal) return headers_.value(section);
+  return section + 1;
+}
+
+QVariant StoreTableModel::data(const QModelIndex& index, int role) const {
+  if (role != Qt::DisplayRole || !index.isValid() || index.row() >= rowCount()) return QVariant();
+  return cell(index.row(), index.column());
+}
+
+void StoreTableModel::showRows(int rows) {
+  if (rows == shown_) return;
+  if (rows < shown_) {
+    beginResetModel();
+    shown_ = rows;
+    endResetModel();
+    return;
+  }
+  beginInsertRows(QModelIndex(), shown_, rows - 1);
+  shown_ = rows;
+  endInsertRows();
+}
+
+void StoreTableModel::rowChanged(int row) {
+  if (row < 0 || row >= rowCount()) return;
+  emit dataChanged(index(row, 0), index(row, columnCount() - 1), {Qt::DisplayRole});
+}
+
+void StoreTableModel::columnChanged(int column) {
+  if (rowCount() == 0) return;
+  emit dataChanged(index(0, column), index(rowCount() - 1, column), {Qt::DisplayRole});
+}
+
+void StoreTableModel::reload() {
+  TRACE_SCOPE("gui.reloadModel");
+  beginResetModel();
+  endResetModel();
+}
+
+WorkOrderTableModel::WorkOrderTableModel(const std::vector<WorkOrder>& orders, QObject* parent)
+    : StoreTableModel({QObject::tr("ID"), QObject::tr("Vehicle"), QObject::tr("Customer"), QObject::tr("Mechanic"),
+                       QObject::tr("Status"), QObject::tr("Total"), QObject::tr("Detection")},
+                      static_cast<int>(orders.size()), parent),
+      orders_(orders) {}
+
+QVariant WorkOrderTableModel::cell(int row, int column) const {
+  const auto& w = orders_[row];
+  switch (column) {
+    case 0: return QString::fromStdString(w.id);
+    case 1: return QString::fromStdString(w.vehicle.plate);
+    case 2: return QString::fromStdString(w.customer.name);
+    case 3: return QString::fromStdString(w.tech.name);
+    case 4: return statusToText(w.status);
+    case 5: return QString::number(w.previewTotal());
+    case 6: return QString::fromStdString(w.detectionNote);
+  }
+  return QVariant();
+}
+
+TechnicianTableModel::TechnicianTableModel(const std::vector<Technician>& technicians, QObject* parent)
+    : StoreTableModel({QObject::tr("ID"), QObject::tr("Name"), QObject::tr("Hourly Rate"),
+                       QObject::tr("Assigned Orders")}, static_cast<int>(technicians.size()), parent),
+      technicians_(technicians) {}
+
+QVariant TechnicianTableModel::cell(int row, int column) const {
+  const auto& t = technicians_[row];
+  switch (column) {
+    case 0: return QString::fromStdString(t.id);
+    case 1: return QString::fromStdString(t.name);
+    case 2: return QString::number(t.hourlyRate);
+    case 3: return joinIds(t.assignedWorkOrders, IdTable::workOrders());
+  }
+  return QVariant();
+}
+
+InventoryTableModel::InventoryTableModel(std::vector<Part>& parts, QObject* parent)
+    : StoreTableModel({QObject::tr("Part ID"), QObject::tr("Name"), QObject::tr("Stock"), QObject::tr("Capacity")}, 0,
+                      parent),
+      parts_(parts) {}
+
+int InventoryTableModel::rowCount(const QModelIndex& parent) const {
+  return parent.isValid() ? 0 : static_cast<int>(parts_.size());
+}
+
+void InventoryTableModel::replace(std::vector<Part> snapshot) {
+  bool sameRows = snapshot.size() == parts_.size();
+  for (std::size_t i = 0; sameRows && i < snapshot.size(); ++i) sameRows = snapshot[i].id == parts_[i].id;
+  if (!sameRows) {
+    beginResetModel();
+    parts_ = std::move(snapshot);
+    endResetModel();
+    return;
+  }
+  for (std::size_t i = 0; i < snapshot.size(); ++i) {
+    const bool moved = snapshot[i].stock != parts_[i].stock || snapshot[i].capacity != parts_[i].capacity;
+    parts_[i] = std::move(snapshot[i]);
+    if (moved) rowChanged(static_cast<int>(i));
+  }
+}
+
+QVariant InventoryTableModel::cell(int row, int column) const {
+  const auto& p = parts_[row];
+  switch (column) {
+    case 0: return QString::fromStdString(p.id);
+    case 1: return QString::fromStdString(p.name);
+    case 2: return p.stock;
+    case 3: return p.capacity;
+  }
+  return QVariant();
+}
+
+VehicleTableModel::VehicleTableModel(const std::vector<Vehicle>& vehicles, QObject* parent)
+    : StoreTableModel({QObject::tr("VIN"), QObject::tr("Plate"), QObject::tr("Brand"), QObject::tr("Model"),
+                       QObject::tr("Year"), QObject::tr("Mileage")}, 0, parent),
+      vehicles_(vehicles) {}
+
+int VehicleTableModel::rowCount(const QModelIndex& parent) const {
+  return parent.isValid() ? 0 : static_cast<int>(rows_.size());
+}
+
+void VehicleTableModel::setOwner(const std::string& customerId) {
+  beginResetModel();
+  ownerId_ = customerId;
+  rows_.clear();
+  for (std::size_t i = 0; i < vehicles_.size(); ++i) {
+    if (vehicles_[i].ownerId == ownerId_) rows_.push_back(i);
+  }
+  endResetModel();
+}
+
+void VehicleTableModel::vehicleAdded(std::size_t index) {
+  if (index >= vehicles_.size() || vehicles_[index].ownerId != ownerId_) return;
+  const int row = static_cast<int>(rows_.size());
+  beginInsertRows(QModelIndex(), row, row);
+  rows_.push_back(index);
+  endInsertRows();
+}
+
+void VehicleTableModel::vehicleChanged(std::size_t index) {
+  auto it = std::find(rows_.begin(), rows_.end(), index);
+  if (it != rows_.end()) rowChanged(static_cast<int>(it - rows_.begin()));
+}
+
+QVariant VehicleTableModel::cell(int row, int column) const {
+  const auto& v = vehicles_[rows_[row]];
+  switch (column) {
+    case 0: return QString::fromStdString(v.vin);
+    case 1: return QString::fromStdString(v.plate);
+    case 2: return QString::fromStdString(v.brand);
+    case 3: return QString::fromStdString(v.model);
+    case 4: return v.year;
+    case 5: return v.mileage;
+  }
+  return QVariant();
+}
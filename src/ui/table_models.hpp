@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QStringList>
+#include <string>
+#include <vector>
+#include "domain/data_store.hpp"
+
+// Read-only table over a vector owned by DataStore. Views ask only for the
+// cells they paint, so nothing is allocated per row up front; callers report
+// what changed and views repaint just those rows. The row count is what was
+// last announced with showRows, so appends may be announced a tick later.
+class StoreTableModel : public QAbstractTableModel {
+public:
+  StoreTableModel(QStringList headers, int rows, QObject* parent = nullptr);
+
+  int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+  int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+  QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+  QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+  // Announces rows appended to the backing vector since the last call.
+  void showRows(int rows);
+  void rowChanged(int row);
+  void columnChanged(int column);
+  void reload();
+
+protected:
+  virtual QVariant cell(int row, int column) const = 0;
+
+private:
+  QStringList headers_;
+  int shown_{0};
+};
+
+class WorkOrderTableModel : public StoreTableModel {
+public:
+  explicit WorkOrderTableModel(const std::vector<WorkOrder>& orders, QObject* parent = nullptr);
+
+protected:
+  QVariant cell(int row, int column) const override;
+
+private:
+  const std::vector<WorkOrder>& orders_;
+};
+
+class TechnicianTableModel : public StoreTableModel {
+public:
+  explicit TechnicianTableModel(const std::vector<Technician>& technicians, QObject* parent = nullptr);
+
+protected:
+  QVariant cell(int row, int column) const override;
+
+private:
+  const std::vector<Technician>& technicians_;
+};
+
+class InventoryTableModel : public StoreTableModel {
+public:
+  explicit InventoryTableModel(std::vector<Part>& parts, QObject* parent = nullptr);
+  int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+  // Stores a storehouse snapshot, signalling only rows whose stock moved.
+  void replace(std::vector<Part> snapshot);
+
+protected:
+  QVariant cell(int row, int column) const override;
+
+private:
+  std::vector<Part>& parts_;
+};
+
+// Vehicles of one customer; rows map to indexes into the store's vector.
+class VehicleTableModel : public StoreTableModel {
+public:
+  explicit VehicleTableModel(const std::vector<Vehicle>& vehicles, QObject* parent = nullptr);
+  int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+  void setOwner(const std::string& customerId);
+  // Call after vehicles.push_back; shows the vehicle if it belongs to the owner.
+  void vehicleAdded(std::size_t index);
+  void vehicleChanged(std::size_t index);
+
+protected:
+  QVariant cell(int row, int column) const override;
+
+private:
+  const std::vector<Vehicle>& vehicles_;
+  std::string ownerId_;
+  std::vector<std::size_t> rows_;
+};
+
+QString statusToText(WOStatus st);
+QString joinIds(const std::vector<std::string>& ids);
+// Names of interned ids from `table`
+QString joinIds(const std::vector<IdHandle>& ids, const IdTable& table);
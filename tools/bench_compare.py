@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+"""Compares two bench_auto_repair result files.
+
+Prints the median time of every benchmark in both runs and the change, and
+exits 1 if any benchmark got slower than the threshold allows. When both
+runs carry a memory footprint, the bytes per entity type are compared too
+(for information only).
+
+  python3 tools/bench_compare.py base.json head.json --threshold 10
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    return data, {r["name"]: r for r in data["results"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("base")
+    parser.add_argument("head")
+    parser.add_argument("--threshold", type=float, default=10.0, help="allowed slowdown in percent")
+    args = parser.parse_args()
+
+    base, base_results = load(args.base)
+    head, head_results = load(args.head)
+    if base["scale"] != head["scale"]:
+        print("warning: runs use different scales: %s vs %s" % (base["scale"], head["scale"]))
+
+    print("%-32s %14s %14s %9s" % ("benchmark", base["commit"], head["commit"], "change"))
+    regressions = []
+    for name, result in head_results.items():
+        if name not in base_results:
+            print("%-32s %14s %14.3f %9s" % (name, "-", result["median_ns"] / 1e6, "new"))
+            continue
+        before, after = base_results[name]["median_ns"], result["median_ns"]
+        change = 100.0 * (after - before) / before if before else 0.0
+        flag = ""
+        if change > args.threshold:
+            regressions.append(name)
+            flag = "  REGRESSION"
+        print("%-32s %14.3f %14.3f %+8.1f%%%s" % (name, before / 1e6, after / 1e6, change, flag))
+
+    base_memory = {r["type"]: r for r in base.get("memory", {}).get("types", [])}
+    head_memory = {r["type"]: r for r in head.get("memory", {}).get("types", [])}
+    if base_memory and head_memory:
+        print()
+        print("%-32s %14s %14s %9s" % ("memory (bytes)", base["commit"], head["commit"], "change"))
+        for name, row in head_memory.items():
+            before = base_memory.get(name, {}).get("total_bytes", 0)
+            after = row["total_bytes"]
+            change = "%+8.1f%%" % (100.0 * (after - before) / before) if before else "new"
+            print("%-32s %14d %14d %9s" % (name, before, after, change))
+
+    if regressions:
+        print("%d benchmark(s) slower than %.1f%%: %s" % (len(regressions), args.threshold, ", ".join(regressions)))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
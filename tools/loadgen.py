@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""Load generator for auto_repair_server.
+
+Each worker process keeps one keep-alive connection open and loops over a
+scenario until the duration runs out:
+
+  read       GET a work order, the inventory page and a search
+  lifecycle  POST a vehicle, create its order, start, complete, settle
+  mixed      one lifecycle per nine reads
+
+Prints requests/s, errors and latency percentiles. Standard library only.
+
+  python3 tools/loadgen.py --port 8080 --workers 8 --duration 10 --scenario mixed
+"""
+
+import argparse
+import http.client
+import json
+import multiprocessing
+import os
+import time
+
+
+def call(conn, method, path, body=None):
+    payload = json.dumps(body) if body is not None else None
+    headers = {"Content-Type": "application/json"} if payload else {}
+    started = time.perf_counter()
+    conn.request(method, path, body=payload, headers=headers)
+    response = conn.getresponse()
+    data = response.read()
+    return response.status, data, time.perf_counter() - started
+
+
+def setup(host, port):
+    """Makes sure a customer and a technician exist; returns their ids."""
+    conn = http.client.HTTPConnection(host, port)
+    call(conn, "POST", "/technicians", {"id": "LOADTECH", "name": "Load Tech", "hourlyRate": 100})
+    status, data, _ = call(conn, "POST", "/customers", {"name": "Load Customer", "phone": "000"})
+    if status != 201:
+        raise SystemExit("cannot create customer: %s" % data)
+    conn.close()
+    return json.loads(data)["id"], "LOADTECH"
+
+
+def worker(args, customer, tech, index, results):
+    conn = http.client.HTTPConnection(args.host, args.port)
+    prefix = "LG%d-%d-" % (os.getpid(), index)
+    latencies, errors, sequence = [], 0, 0
+    deadline = time.perf_counter() + args.duration
+
+    def run(method, path, body=None, expect=(200, 201)):
+        nonlocal errors
+        status, _, elapsed = call(conn, method, path, body)
+        latencies.append(elapsed)
+        if status not in expect:
+            errors += 1
+        return status
+
+    def reads():
+        run("GET", "/workorders?limit=20")
+        run("GET", "/inventory")
+        run("GET", "/search?q=VIN")
+
+    def lifecycle():
+        nonlocal sequence
+        sequence += 1
+        vin = prefix + str(sequence)
+        run("POST", "/vehicles", {"vin": vin, "plate": vin, "brand": "Toyota", "model": "Corolla",
+                                   "year": 2019, "ownerId": customer, "mileage": 60000})
+        run("POST", "/workorders", {"vin": vin, "techId": tech})
+        for action in ("start", "complete", "settle"):
+            run("POST", "/workorders/%s/%s" % (vin, action))
+
+    while time.perf_counter() < deadline:
+        if args.scenario == "read":
+            reads()
+        elif args.scenario == "lifecycle":
+            lifecycle()
+        else:
+            lifecycle()
+            for _ in range(3):
+                reads()
+    conn.close()
+    results.put((latencies, errors))
+
+
+def percentile(sorted_values, p):
+    if not sorted_values:
+        return 0.0
+    return sorted_values[min(len(sorted_values) - 1, int(p * len(sorted_values)))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--workers", type=int, default=4)
+    parser.add_argument("--duration", type=float, default=10.0, help="seconds")
+    parser.add_argument("--scenario", choices=("read", "lifecycle", "mixed"), default="mixed")
+    args = parser.parse_args()
+
+    customer, tech = setup(args.host, args.port)
+    results = multiprocessing.Queue()
+    procs = [multiprocessing.Process(target=worker, args=(args, customer, tech, i, results))
+             for i in range(args.workers)]
+    started = time.perf_counter()
+    for p in procs:
+        p.start()
+    latencies, errors = [], 0
+    for _ in procs:
+        lat, err = results.get()
+        latencies.extend(lat)
+        errors += err
+    for p in procs:
+        p.join()
+    elapsed = time.perf_counter() - started
+
+    latencies.sort()
+    print("scenario=%s workers=%d requests=%d errors=%d elapsed=%.2fs" %
+          (args.scenario, args.workers, len(latencies), errors, elapsed))
+    print("throughput=%.0f req/s" % (len(latencies) / elapsed))
+    print("latency_ms p50=%.2f p90=%.2f p99=%.2f max=%.2f" %
+          tuple(1000 * v for v in (percentile(latencies, 0.5), percentile(latencies, 0.9),
+                                   percentile(latencies, 0.99), latencies[-1] if latencies else 0.0)))
+
+
+if __name__ == "__main__":
+    main()